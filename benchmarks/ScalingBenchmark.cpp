@@ -0,0 +1,311 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+// Scaling benchmark: tokenizes and parses generated inputs of growing size
+// and token density with ReferenceTokenizer and a minimal parser, on one and
+// on all cores, and writes a ScalingReport as CSV.
+//
+//   ScalingBenchmark [max_megabytes = 64] [output.csv]
+//
+// Input sizes grow by a factor of 4 from 1 MB up to max_megabytes (at most
+// 4096). When running on N cores every core processes its own document of
+// 1/N of the input size.
+
+#include "../src/parser/AbstractParser.h"
+#include "../src/profiling/ScalingReport.h"
+#include "../src/verification/ReferenceTokenizer.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+
+ABSTRACTPARSER_COUNT_ALLOCATIONS
+
+using namespace Abstract::Parsing;
+using namespace Abstract::Profiling;
+using namespace Abstract::Verification;
+
+namespace {
+
+const uint64_t MEGABYTE = 1024 * 1024;
+const uint64_t MAX_MEGABYTES = 4096;
+
+// Share of each token class in a generated input, in percent; the rest
+// are single character tokens
+struct Density
+{
+    const char *name;
+    uint8_t terms, strings, comments;
+    uint16_t max_term_length, max_string_length, max_comment_length;
+};
+
+const Density DENSITIES[] {
+    {"dense",  40,  5,  0,    3,   8,    0},
+    {"mixed",  50, 15,  5,   12,  40,  120},
+    {"sparse", 20, 20, 30,   24, 400, 4000}
+};
+
+// Tokens of an input with the given density; comment and string contents
+// never contain their delimiters, so the input always tokenizes
+string
+generateInput(const uint64_t size, const Density &density, const uint32_t seed)
+{
+    static const char LETTERS[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    static const char CHARACTERS[] = "(){}[];,.=+-<>";
+
+    mt19937 random(seed);
+    string input;
+    input.reserve(size_t(size));
+
+    const auto letters = [&](const uint16_t max_length) {
+        for (auto length = 1 + random() % max_length; length--;)
+            input += LETTERS[random() % (sizeof(LETTERS) - 1)];
+    };
+
+    const unsigned terms = density.terms,
+                   strings = terms + density.strings,
+                   comments = strings + density.comments;
+
+    while (input.length() < size) {
+        const auto kind = unsigned(random() % 100);
+
+        if (kind < terms)
+            letters(density.max_term_length);
+        else if (kind < strings) {
+            input += '"';
+            letters(density.max_string_length);
+            input += '"';
+        }
+        else if (kind < comments) {
+            input += "/* ";
+            letters(density.max_comment_length);
+            input += " */";
+        }
+        else
+            input += CHARACTERS[random() % (sizeof(CHARACTERS) - 1)];
+
+        input += random() % 16 ? ' ' : '\n';
+    }
+
+    return input;
+}
+
+// Minimal parser over the tokens of ReferenceTokenizer: dispatches on the
+// token kind and tracks the nesting of brackets
+class ReferenceParser : public AbstractParser
+{
+public:
+    explicit
+    ReferenceParser(AbstractTokenStreamPtr token_stream) :
+        AbstractParser(move(token_stream)) {}
+
+    bool
+    parse                   ();
+
+    int64_t
+    maxDepth                () const;
+
+protected:
+    void
+    throwParseError(const string &message) override
+    {
+        setErrorMessage(message);
+        setParseError();
+    }
+
+private:
+    int64_t m_max_depth {0};
+};
+
+bool
+ReferenceParser::
+parse()
+{
+    enum : int16_t { VALUE, COMMENT, CHARACTER };
+
+    static const DispatchTable alternatives {
+        TokenKindSet {ReferenceTokenizer::TERM, ReferenceTokenizer::STRING},
+        TokenKindSet {ReferenceTokenizer::COMMENT},
+        TokenKindSet {ReferenceTokenizer::CHARACTER}
+    };
+
+    int64_t depth = 0;
+
+    while (!isEnd()) {
+        switch (predict(alternatives)) {
+        case VALUE:
+        case COMMENT:
+            break;
+
+        case CHARACTER: {
+            const auto ch = currentToken()->content()[0];
+
+            if (ch == '(' || ch == '{' || ch == '[')
+                m_max_depth = max(m_max_depth, ++depth);
+            else if (ch == ')' || ch == '}' || ch == ']')
+                --depth;
+            break;
+        }
+
+        default:
+            throwParseError("Unexpected token");
+            return false;
+        }
+
+        advance();
+    }
+
+    return !parseError();
+}
+
+int64_t
+ReferenceParser::
+maxDepth() const
+{
+    return m_max_depth;
+}
+
+// Result of one worker; the tokens are kept, so their memory can be
+// estimated outside the timed and allocation counted region
+struct Run
+{
+    AbstractTokenStreamPtr tokens;
+    int64_t max_depth {0};
+    bool ok {true};
+};
+
+void
+tokenizeAndParse(const string &input, Run &run)
+{
+    ReferenceTokenizer tokenizer(input);
+
+    if (!tokenizer.run()) {
+        run.ok = false;
+        return;
+    }
+
+    ReferenceParser parser(tokenizer.tokens());
+    run.ok = parser.parse();
+    run.max_depth = parser.maxDepth();
+    run.tokens = tokenizer.tokens();
+}
+
+void
+printUsage(ostream &out)
+{
+    out << "Usage: ScalingBenchmark [max_megabytes = 64] [output.csv]" << endl
+        << "Input sizes grow by a factor of 4 from 1 MB up to max_megabytes (1 to "
+        << MAX_MEGABYTES << ")." << endl;
+}
+
+} // namespace
+
+int
+main(int argc, char *argv[])
+{
+    uint64_t max_megabytes = 64;
+
+    if (argc > 1) {
+        const string argument = argv[1];
+        char *end;
+
+        if (argument == "-h" || argument == "--help") {
+            printUsage(cout);
+            return 0;
+        }
+
+        max_megabytes = strtoull(argv[1], &end, 10);
+
+        if (*end || !max_megabytes || !isdigit(uint8_t(argument[0]))) {
+            printUsage(cerr);
+            return 1;
+        }
+
+        max_megabytes = min(max_megabytes, MAX_MEGABYTES);
+    }
+
+    const unsigned cores = max(1u, thread::hardware_concurrency());
+
+    vector<unsigned> thread_counts {1};
+
+    if (cores > 1)
+        thread_counts.push_back(cores);
+
+    ScalingReport report;
+
+    for (const auto &density : DENSITIES) {
+        for (const auto threads : thread_counts) {
+            for (uint64_t megabytes = 1; megabytes <= max_megabytes; megabytes *= 4) {
+                vector<string> inputs;
+
+                for (unsigned i = 0; i < threads; ++i)
+                    inputs.push_back(generateInput(megabytes * MEGABYTE / threads, density, i + 1));
+
+                vector<Run> runs(threads);
+                vector<thread> workers;
+
+                const auto allocations = AllocationCounter::allocations();
+                const auto begin = chrono::steady_clock::now();
+
+                for (unsigned i = 0; i < threads; ++i)
+                    workers.emplace_back(tokenizeAndParse, cref(inputs[i]), ref(runs[i]));
+
+                for (auto &worker : workers)
+                    worker.join();
+
+                const chrono::duration<double> seconds = chrono::steady_clock::now() - begin;
+
+                ScalingReport::Sample sample {
+                    string(density.name) + "/" + to_string(threads) + "t",
+                    0, 0, seconds.count(),
+                    ScalingReport::peakResidentSetSize(),
+                    AllocationCounter::allocations() - allocations, 0
+                };
+
+                for (unsigned i = 0; i < threads; ++i) {
+                    if (!runs[i].ok) {
+                        cerr << "Tokenizing or parsing the generated input failed" << endl;
+                        return 1;
+                    }
+
+                    sample.input_bytes += inputs[i].length();
+                    sample.token_count += runs[i].tokens->size();
+                    sample.token_memory_bytes += ScalingReport::tokenStreamMemory(*runs[i].tokens);
+                }
+
+                report.addSample(sample);
+                cerr << sample.label << ' ' << megabytes << " MB: " << sample.seconds << " s" << endl;
+            }
+        }
+    }
+
+    if (argc > 2) {
+        ofstream file(argv[2]);
+        file << report.toCsv();
+        return file ? 0 : 1;
+    }
+
+    cout << report.toCsv();
+    return 0;
+}
@@ -0,0 +1,66 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "../src/verification/DifferentialCheck.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+using namespace Abstract::Verification;
+
+// libFuzzer entry point: every input has to produce the same tokens in all
+// scanning modes as the byte-wise reference. Seed inputs are in
+// fuzz/corpus, e.g.
+//   DifferentialFuzzer -max_len=65536 new_corpus fuzz/corpus
+extern "C" int
+LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    string report;
+
+    if (!DifferentialCheck::run(string(data, data + size), report)) {
+        cerr << report << endl;
+        abort();
+    }
+
+    return 0;
+}
+
+#ifdef ABSTRACTPARSER_FUZZ_REPLAY
+// Without libFuzzer the inputs given on the command line (e.g. the seed
+// corpus or a crash reproducer) are replayed once
+int
+main(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        ifstream file(argv[i], ios::binary);
+
+        if (!file) {
+            cerr << "Can't read " << argv[i] << endl;
+            return 1;
+        }
+
+        const string input((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t *>(input.data()), input.size());
+    }
+
+    return 0;
+}
+#endif
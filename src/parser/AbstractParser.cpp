@@ -25,7 +25,96 @@ using namespace Abstract::Parsing;
 
 AbstractParser::AbstractParser(AbstractTokenStreamPtr token_stream) :
     m_token_stream(move(token_stream)),
-    m_iterator(m_token_stream->begin()) {}
+    m_iterator(m_token_stream->begin()),
+    m_segment_begin(m_iterator),
+    m_segment_end(m_token_stream->end()) {}
+
+AbstractParser::AbstractParser(const FrozenTokenStream &token_stream) :
+    m_token_stream(token_stream.m_token_stream),
+    m_iterator(m_token_stream->begin()),
+    m_segment_begin(m_iterator),
+    m_segment_end(m_token_stream->end()) {}
+
+AbstractParser::AbstractParser(SplicedTokenStreamPtr token_stream) :
+    m_spliced_stream(move(token_stream))
+{
+    seek(0);
+}
+
+void
+AbstractParser::
+reset()
+{
+    while (!m_position_stack.empty())
+        m_position_stack.pop();
+
+    m_structural_index.reset();
+
+    if (m_spliced_stream)
+        seek(0);
+    else {
+        m_iterator = m_segment_begin = m_token_stream->begin();
+        m_segment_end = m_token_stream->end();
+    }
+
+    m_parse_error = false;
+    m_error_message.clear();
+}
+
+void
+AbstractParser::
+reset(AbstractTokenStreamPtr token_stream)
+{
+    m_token_stream = move(token_stream);
+    m_spliced_stream.reset();
+    m_segment = m_segment_offset = 0;
+    reset();
+}
+
+void
+AbstractParser::
+reset(SplicedTokenStreamPtr token_stream)
+{
+    m_spliced_stream = move(token_stream);
+    reset();
+}
+
+void
+AbstractParser::
+seek(const size_t position) const
+{
+    const auto segment = m_spliced_stream->segmentOf(position);
+
+    if (segment < m_spliced_stream->segmentCount()) {
+        enterSegment(segment);
+        m_iterator = m_segment_begin + int64_t(position - m_segment_offset);
+    }
+    else if (segment) {
+        // End of the stream, stay behind the last token of the last segment
+        enterSegment(segment - 1);
+        m_iterator = m_segment_end;
+    }
+    else {
+        static const AbstractTokenStreamPtr empty_stream = make_shared<AbstractTokenStream>();
+
+        m_token_stream = empty_stream;
+        m_iterator = m_segment_begin = m_segment_end = m_token_stream->begin();
+        m_segment = m_segment_offset = 0;
+    }
+}
+
+void
+AbstractParser::
+enterSegment(const size_t segment) const
+{
+    const auto &s = m_spliced_stream->segment(segment);
+
+    m_token_stream = s.tokens;
+    m_segment = segment;
+    m_segment_offset = s.offset;
+    m_segment_begin = m_iterator = m_token_stream->begin() + int64_t(s.begin);
+    m_segment_end = m_token_stream->begin() + int64_t(s.end);
+}
 
 void
 AbstractParser::
@@ -33,3 +122,14 @@ setErrorMessage(const string &message)
 {
     m_error_message = message;
 }
+
+bool
+AbstractParser::
+expectOneOf(const TokenKindSet &kinds, const string &message)
+{
+    if (!isEnd() && kinds.contains(*currentToken()))
+        return advance();
+
+    throwParseError(message);
+    return false;
+}
@@ -37,7 +37,13 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #endif
 
 #include "../tokenizer/AbstractTokenizer.h"
+#include "FrozenTokenStream.h"
+#include "OperatorTable.h"
+#include "SplicedTokenStream.h"
+#include "StructuralIndex.h"
+#include "TokenKindSet.h"
 #include <stack>
+#include <vector>
 
 namespace Abstract {
 namespace Parsing {
@@ -45,6 +51,19 @@ using namespace std;
 using namespace Abstract::Tokenization;
 using namespace Abstract::Tokenization::Tokens;
 
+// A parser instance is not thread-safe, but any number of parsers may run
+// concurrently on one FrozenTokenStream, as parsers only hold the token
+// stream they read through a pointer to const. Tokens are shared, though:
+// parsers must not modify them (e.g. currentToken()->setContent) while
+// other threads read the same stream.
+//
+// Parsers read the stream through const iterators only. Rewriting the
+// stream while parsing (e.g. splitting a ">>" token) has to be done on the
+// AbstractTokenStreamPtr before the parser is constructed or reset.
+//
+// A parser constructed from a SplicedTokenStream walks its segments
+// transparently. Iterators (getIterator/setIterator) then refer to the
+// current segment only; rememberPosition/resetPosition work across segments.
 class ABSTRACTPARSER_EXPORT AbstractParser
 {
 public:
@@ -59,33 +78,66 @@ public:
     AbstractParser &operator=(const AbstractParser &&) = delete;
 
     explicit
-    AbstractParser(AbstractTokenStreamPtr token_stream);
+    AbstractParser(AbstractTokenStreamPtr token_stream),
+    AbstractParser(const FrozenTokenStream &token_stream),
+    AbstractParser(SplicedTokenStreamPtr token_stream);
     virtual ~AbstractParser() = default;
 
+    // Restarts parsing at the beginning of the (refilled) token stream,
+    // keeping the capacity of the position stack and the error message
+    // buffer. The structural index is dropped, as it was built over the
+    // previous contents of the stream; set a rebuilt one after resetting.
+    void
+    reset               (),
+    reset               (AbstractTokenStreamPtr token_stream),
+    reset               (SplicedTokenStreamPtr token_stream);
+
 protected:
-    inline const AbstractTokenStreamPtr
+    // The token stream currently read, i.e. the stream of the current
+    // segment of a spliced stream
+    inline const ConstAbstractTokenStreamPtr &
     tokenStream         () const;
 
+    inline const SplicedTokenStreamPtr &
+    splicedTokenStream  () const;
+
+    // Index of the current token within the whole (spliced) token stream
+    inline size_t
+    position            () const;
+
     inline bool
     advance(const int64_t count = 1) const,
+    isEnd               (const int64_t count = 0) const,
+
+    // If the current token opens a bracket pair known to the structural
+    // index, moves behind its closing bracket in O(1) and returns true
+    skipBalanced        () const,
 
     parseError          () const;
 
-    inline const AbstractTokenPtr
-    prevToken           () const,
-    currentToken        (const int64_t count = 0) const,
+    inline const AbstractTokenPtr &
+    prevToken           () const;
+
+    inline const AbstractTokenPtr &
+    currentToken        (const int64_t count = 0) const;
+
+    inline const AbstractTokenPtr &
     nextToken           () const;
 
-    inline const AbstractTokenStream::iterator
+    inline const AbstractTokenStream::const_iterator
     getIterator         () const;
 
     inline void
-    setIterator         (const AbstractTokenStream::iterator iterator),
+    setIterator         (const AbstractTokenStream::const_iterator iterator),
     rememberPosition    (),
     resetPosition       (),
     popPosition         (),
 
-    setParseError       ();
+    setParseError       (),
+
+    // Index built over the token stream of this parser; may be shared by
+    // parsers reading the same stream
+    setStructuralIndex  (shared_ptr<const StructuralIndex> index);
 
 	void
     setErrorMessage     (const string &message);
@@ -96,59 +148,176 @@ protected:
     virtual void
     throwParseError     (const string &message) = 0;
 
+    // Index of the alternative whose FIRST set contains the kind of the
+    // current token, DispatchTable::NO_ALTERNATIVE or, if several do,
+    // DispatchTable::AMBIGUOUS, in which case speculative parsing is needed
+    inline int16_t
+    predict             (const DispatchTable &alternatives) const;
+
+    // Consumes the current token if its kind is contained in the given set,
+    // otherwise reports a parse error
+    bool
+    expectOneOf         (const TokenKindSet &kinds, const string &message = "");
+
+    // Precedence climbing over the operators of the given table, starting at
+    // the current token. Node must be default constructible and convert to
+    // false on failure (e.g. a shared_ptr). The callbacks are
+    //   Node parse_primary()
+    //   Node make_prefix (const AbstractTokenPtr &op, Node operand)
+    //   Node make_infix  (const AbstractTokenPtr &op, Node lhs, Node rhs)
+    //   Node make_postfix(const AbstractTokenPtr &op, Node operand)
+    template<class Node, class ParsePrimary, class MakePrefix, class MakeInfix, class MakePostfix>
+    Node
+    parseExpression     (const OperatorTable &operators,
+                         ParsePrimary &&parse_primary,
+                         MakePrefix &&make_prefix,
+                         MakeInfix &&make_infix,
+                         MakePostfix &&make_postfix,
+                         const uint16_t min_binding_power = 0);
+
 private:
-    const AbstractTokenStreamPtr m_token_stream;
-    stack<AbstractTokenStream::iterator> m_position_stack;
-    mutable AbstractTokenStream::iterator m_iterator;
+    struct Position
+    {
+        size_t segment;
+        AbstractTokenStream::const_iterator iterator;
+    };
+
+    inline bool
+    inSegment           (const int64_t count) const;
+
+    void
+    seek                (const size_t position) const,
+    enterSegment        (const size_t segment) const;
+
+    mutable ConstAbstractTokenStreamPtr m_token_stream;
+    SplicedTokenStreamPtr m_spliced_stream;
+    shared_ptr<const StructuralIndex> m_structural_index;
+    stack<Position, vector<Position>> m_position_stack;
+    mutable AbstractTokenStream::const_iterator m_iterator, m_segment_begin, m_segment_end;
+    mutable size_t m_segment {0}, m_segment_offset {0};
 
     bool m_parse_error {false};
     string m_error_message;
 };
 
-inline const AbstractTokenStreamPtr
+inline const ConstAbstractTokenStreamPtr &
 AbstractParser::
 tokenStream() const
 {
     return m_token_stream;
 }
 
+inline const SplicedTokenStreamPtr &
+AbstractParser::
+splicedTokenStream() const
+{
+    return m_spliced_stream;
+}
+
+inline size_t
+AbstractParser::
+position() const
+{
+    return m_segment_offset + size_t(m_iterator - m_segment_begin);
+}
+
+inline bool
+AbstractParser::
+inSegment(const int64_t count) const
+{
+    return count >= 0 ? count < m_segment_end - m_iterator
+                      : -count <= m_iterator - m_segment_begin;
+}
+
 inline bool
 AbstractParser::
 advance(const int64_t count) const
 {
-    m_iterator += count;
+    if (!m_spliced_stream || inSegment(count))
+        m_iterator += count;
+    else
+        seek(size_t(int64_t(position()) + count));
+
     return true;
 }
 
-inline const AbstractTokenPtr
+inline bool
+AbstractParser::
+isEnd(const int64_t count) const
+{
+    if (m_segment_end - m_iterator > count || !m_spliced_stream)
+        return m_segment_end - m_iterator <= count;
+
+    return int64_t(m_spliced_stream->size() - position()) <= count;
+}
+
+inline bool
+AbstractParser::
+skipBalanced() const
+{
+    if (!m_structural_index)
+        return false;
+
+    const auto current = position();
+    const auto match = m_structural_index->match(current);
+
+    if (match == StructuralIndex::NO_MATCH)
+        return false;
+
+    return advance(int64_t(match - current) + 1);
+}
+
+inline int16_t
+AbstractParser::
+predict(const DispatchTable &alternatives) const
+{
+    if (isEnd()) {
+        ABSTRACTPARSER_PROFILE_COUNT(predictions, 1);
+        ABSTRACTPARSER_PROFILE_COUNT(prediction_failures, 1);
+        return DispatchTable::NO_ALTERNATIVE;
+    }
+
+    const auto alternative = alternatives.lookup(currentToken()->kind());
+
+    ABSTRACTPARSER_PROFILE_COUNT(predictions, 1);
+    ABSTRACTPARSER_PROFILE_COUNT(prediction_failures, alternative == DispatchTable::NO_ALTERNATIVE);
+    ABSTRACTPARSER_PROFILE_COUNT(prediction_ambiguities, alternative == DispatchTable::AMBIGUOUS);
+
+    return alternative;
+}
+
+inline const AbstractTokenPtr &
 AbstractParser::
 prevToken() const
 {
-    return *(m_iterator-1);
+    return currentToken(-1);
 }
 
-inline const AbstractTokenPtr
+inline const AbstractTokenPtr &
 AbstractParser::
 currentToken(int64_t count) const
 {
-    return *(m_iterator+count);
+    if (!m_spliced_stream || inSegment(count))
+        return *(m_iterator+count);
+
+    return m_spliced_stream->at(size_t(int64_t(position()) + count));
 }
 
-inline const AbstractTokenPtr
+inline const AbstractTokenPtr &
 AbstractParser::
 nextToken() const
 {
-    return *(m_iterator+1);
+    return currentToken(1);
 }
 
 inline void
 AbstractParser::
-setIterator(const AbstractTokenStream::iterator iterator)
+setIterator(const AbstractTokenStream::const_iterator iterator)
 {
     m_iterator = iterator;
 }
 
-inline const AbstractTokenStream::iterator
+inline const AbstractTokenStream::const_iterator
 AbstractParser::
 getIterator() const
 {
@@ -159,15 +328,28 @@ inline void
 AbstractParser::
 rememberPosition()
 {
-    m_position_stack.push(m_iterator);
+    m_position_stack.push({m_segment, m_iterator});
+    ABSTRACTPARSER_PROFILE_COUNT(positions_remembered, 1);
+    ABSTRACTPARSER_PROFILE_MAX(max_backtrack_depth, m_position_stack.size());
 }
 
 inline void
 AbstractParser::
 resetPosition()
 {
-    m_iterator = m_position_stack.top();
+    ABSTRACTPARSER_PROFILE_COUNT(positions_reset, 1);
+    const auto &top = m_position_stack.top();
+#ifdef ABSTRACTPARSER_PROFILING
+    const auto current = position();
+#endif
+
+    if (top.segment != m_segment)
+        enterSegment(top.segment);
+
+    m_iterator = top.iterator;
     m_position_stack.pop();
+
+    ABSTRACTPARSER_PROFILE_COUNT(tokens_rescanned, current > position() ? current - position() : 0);
 }
 
 inline void
@@ -177,6 +359,13 @@ popPosition()
     m_position_stack.pop();
 }
 
+inline void
+AbstractParser::
+setStructuralIndex(shared_ptr<const StructuralIndex> index)
+{
+    m_structural_index = move(index);
+}
+
 inline void
 AbstractParser::
 setParseError()
@@ -198,6 +387,61 @@ errorMessage() const
     return m_error_message;
 }
 
+template<class Node, class ParsePrimary, class MakePrefix, class MakeInfix, class MakePostfix>
+Node
+AbstractParser::
+parseExpression(const OperatorTable &operators,
+                ParsePrimary &&parse_primary,
+                MakePrefix &&make_prefix,
+                MakeInfix &&make_infix,
+                MakePostfix &&make_postfix,
+                const uint16_t min_binding_power)
+{
+    Node lhs;
+    const OperatorTable::Operator *op;
+
+    if (!isEnd() && (op = operators.prefix(*currentToken()))) {
+        const auto &op_token = currentToken();
+        advance();
+
+        auto operand = parseExpression<Node>(operators, parse_primary, make_prefix,
+                                             make_infix, make_postfix, op->right_binding_power);
+        if (!operand)
+            return Node();
+
+        lhs = make_prefix(op_token, move(operand));
+    }
+    else
+        lhs = parse_primary();
+
+    while (lhs && !isEnd()) {
+        const auto &op_token = currentToken();
+
+        if ((op = operators.postfix(*op_token))) {
+            if (op->left_binding_power < min_binding_power)
+                break;
+
+            advance();
+            lhs = make_postfix(op_token, move(lhs));
+            continue;
+        }
+
+        if (!(op = operators.infix(*op_token)) || op->left_binding_power < min_binding_power)
+            break;
+
+        advance();
+
+        auto rhs = parseExpression<Node>(operators, parse_primary, make_prefix,
+                                         make_infix, make_postfix, op->right_binding_power);
+        if (!rhs)
+            return Node();
+
+        lhs = make_infix(op_token, move(lhs), move(rhs));
+    }
+
+    return lhs;
+}
+
 } // namespace Parsing
 } // namespace Abstract
 
@@ -0,0 +1,149 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef FROZENTOKENSTREAM_H
+#define FROZENTOKENSTREAM_H
+#include "../tokenizer/AbstractTokenizer.h"
+
+namespace Abstract {
+namespace Parsing {
+using namespace std;
+using namespace Abstract::Tokenization;
+
+class TokenCursor;
+
+// Immutable snapshot of a token stream which may be read by any number of
+// threads at the same time without locking. Freezing moves the tokens out of
+// the stream, e.g.
+//   FrozenTokenStream frozen(move(*token_stream));
+// so a tokenizer reset() or refill can't change the snapshot afterwards.
+//
+// The tokens themselves are shared, not copied: the snapshot hands out
+// const AbstractTokenPtr references, through which a token could still be
+// modified (e.g. setContent). Doing so while other threads read the snapshot
+// is a data race; tokens must be treated as read-only once frozen.
+//
+// Each thread uses its own parser or TokenCursor over the snapshot; only
+// constructing a parser copies the shared pointer, walking the stream does
+// not touch any reference count.
+class FrozenTokenStream
+{
+public:
+    explicit
+    FrozenTokenStream(AbstractTokenStream &&token_stream);
+
+    inline const AbstractTokenStream &
+    tokens                  () const;
+
+    inline TokenCursor
+    cursor                  () const;
+
+private:
+    friend class AbstractParser;
+
+    ConstAbstractTokenStreamPtr m_token_stream;
+};
+
+// Lightweight read-only position in a token stream
+class TokenCursor
+{
+public:
+    inline explicit
+    TokenCursor(const AbstractTokenStream &tokens);
+
+    inline const AbstractTokenPtr &
+    current                 (const int64_t count = 0) const;
+
+    inline bool
+    isEnd                   (const int64_t count = 0) const;
+
+    inline void
+    advance                 (const int64_t count = 1),
+    setPosition             (const size_t position);
+
+    inline size_t
+    position                () const;
+
+private:
+    const AbstractTokenPtr *m_begin, *m_end, *m_current;
+};
+
+inline
+FrozenTokenStream::FrozenTokenStream(AbstractTokenStream &&token_stream) :
+    m_token_stream(make_shared<const AbstractTokenStream>(move(token_stream))) {}
+
+inline const AbstractTokenStream &
+FrozenTokenStream::
+tokens() const
+{
+    return *m_token_stream;
+}
+
+inline TokenCursor
+FrozenTokenStream::
+cursor() const
+{
+    return TokenCursor(*m_token_stream);
+}
+
+inline
+TokenCursor::TokenCursor(const AbstractTokenStream &tokens) :
+    m_begin(tokens.data()), m_end(tokens.data() + tokens.size()), m_current(m_begin) {}
+
+inline const AbstractTokenPtr &
+TokenCursor::
+current(const int64_t count) const
+{
+    return *(m_current + count);
+}
+
+inline bool
+TokenCursor::
+isEnd(const int64_t count) const
+{
+    return m_end - m_current <= count;
+}
+
+inline void
+TokenCursor::
+advance(const int64_t count)
+{
+    m_current += count;
+}
+
+inline void
+TokenCursor::
+setPosition(const size_t position)
+{
+    m_current = m_begin + position;
+}
+
+inline size_t
+TokenCursor::
+position() const
+{
+    return size_t(m_current - m_begin);
+}
+
+} // namespace Parsing
+} // namespace Abstract
+
+#endif // FROZENTOKENSTREAM_H
@@ -0,0 +1,71 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "OperatorTable.h"
+using namespace Abstract::Parsing;
+
+OperatorTable &
+OperatorTable::
+addInfix(const string &content, const uint8_t precedence, const Associativity associativity)
+{
+    m_infix.by_content[content] = infixOperator(precedence, associativity);
+    return *this;
+}
+
+OperatorTable &
+OperatorTable::
+addInfix(const uint16_t kind, const uint8_t precedence, const Associativity associativity)
+{
+    m_infix.by_kind[kind] = infixOperator(precedence, associativity);
+    return *this;
+}
+
+OperatorTable &
+OperatorTable::
+addPrefix(const string &content, const uint8_t precedence)
+{
+    m_prefix.by_content[content] = Operator {0, uint16_t(precedence * 2 + 1)};
+    return *this;
+}
+
+OperatorTable &
+OperatorTable::
+addPrefix(const uint16_t kind, const uint8_t precedence)
+{
+    m_prefix.by_kind[kind] = Operator {0, uint16_t(precedence * 2 + 1)};
+    return *this;
+}
+
+OperatorTable &
+OperatorTable::
+addPostfix(const string &content, const uint8_t precedence)
+{
+    m_postfix.by_content[content] = Operator {uint16_t(precedence * 2), 0};
+    return *this;
+}
+
+OperatorTable &
+OperatorTable::
+addPostfix(const uint16_t kind, const uint8_t precedence)
+{
+    m_postfix.by_kind[kind] = Operator {uint16_t(precedence * 2), 0};
+    return *this;
+}
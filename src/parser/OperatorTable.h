@@ -0,0 +1,147 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef OPERATORTABLE_H
+#define OPERATORTABLE_H
+#include "../tokenizer/elements/AbstractToken.h"
+#include <unordered_map>
+
+namespace Abstract {
+namespace Parsing {
+using namespace std;
+using namespace Abstract::Tokenization::Tokens;
+
+// Binding powers of prefix, infix and postfix operators for
+// AbstractParser::parseExpression. Operators are registered either by token
+// kind or by token content; a registered kind takes precedence.
+// Higher precedence levels bind tighter, levels start at 1.
+class OperatorTable
+{
+public:
+    enum Associativity : uint8_t { LEFT, RIGHT };
+
+    struct Operator
+    {
+        uint16_t left_binding_power, right_binding_power;
+    };
+
+    OperatorTable &
+    addInfix                (const string &content, const uint8_t precedence,
+                             const Associativity associativity = LEFT);
+
+    OperatorTable &
+    addInfix                (const uint16_t kind, const uint8_t precedence,
+                             const Associativity associativity = LEFT);
+
+    OperatorTable &
+    addPrefix               (const string &content, const uint8_t precedence);
+
+    OperatorTable &
+    addPrefix               (const uint16_t kind, const uint8_t precedence);
+
+    OperatorTable &
+    addPostfix              (const string &content, const uint8_t precedence);
+
+    OperatorTable &
+    addPostfix              (const uint16_t kind, const uint8_t precedence);
+
+    inline const Operator *
+    infix                   (const AbstractToken &token) const;
+
+    inline const Operator *
+    prefix                  (const AbstractToken &token) const;
+
+    inline const Operator *
+    postfix                 (const AbstractToken &token) const;
+
+private:
+    struct Operators
+    {
+        unordered_map<uint16_t, Operator> by_kind;
+        unordered_map<string, Operator>   by_content;
+    };
+
+    static inline const Operator *
+    find                    (const Operators &operators, const AbstractToken &token);
+
+    static inline Operator
+    infixOperator           (const uint8_t precedence, const Associativity associativity);
+
+    Operators m_infix, m_prefix, m_postfix;
+};
+
+inline const OperatorTable::Operator *
+OperatorTable::
+find(const Operators &operators, const AbstractToken &token)
+{
+    if (!operators.by_kind.empty()) {
+        const auto iter = operators.by_kind.find(token.kind());
+
+        if (iter != operators.by_kind.end())
+            return &iter->second;
+    }
+
+    if (!operators.by_content.empty() && token.contentPtr()) {
+        const auto iter = operators.by_content.find(token.content());
+
+        if (iter != operators.by_content.end())
+            return &iter->second;
+    }
+
+    return nullptr;
+}
+
+inline OperatorTable::Operator
+OperatorTable::
+infixOperator(const uint8_t precedence, const Associativity associativity)
+{
+    const auto power = uint16_t(precedence * 2);
+
+    return associativity == LEFT ?
+        Operator {power, uint16_t(power + 1)} :
+        Operator {uint16_t(power + 1), power};
+}
+
+inline const OperatorTable::Operator *
+OperatorTable::
+infix(const AbstractToken &token) const
+{
+    return find(m_infix, token);
+}
+
+inline const OperatorTable::Operator *
+OperatorTable::
+prefix(const AbstractToken &token) const
+{
+    return find(m_prefix, token);
+}
+
+inline const OperatorTable::Operator *
+OperatorTable::
+postfix(const AbstractToken &token) const
+{
+    return find(m_postfix, token);
+}
+
+} // namespace Parsing
+} // namespace Abstract
+
+#endif // OPERATORTABLE_H
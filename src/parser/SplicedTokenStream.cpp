@@ -0,0 +1,166 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "SplicedTokenStream.h"
+#include <algorithm>
+
+using namespace Abstract::Parsing;
+
+uint32_t
+SplicedTokenStream::
+addOrigin(const string &name, const uint32_t parent, AbstractTokenPtr expansion_point)
+{
+    m_origins.push_back({name, parent, move(expansion_point)});
+    return uint32_t(m_origins.size() - 1);
+}
+
+void
+SplicedTokenStream::
+append(AbstractTokenStreamPtr tokens, const uint32_t origin, const size_t begin, const size_t end)
+{
+    splice(m_size, 0, move(tokens), origin, begin, end);
+}
+
+void
+SplicedTokenStream::
+splice(const size_t position, const size_t erase_count,
+       AbstractTokenStreamPtr tokens, const uint32_t origin,
+       const size_t begin, const size_t end)
+{
+    const size_t erase_end = min(position + erase_count, m_size);
+    size_t first = segmentOf(position);
+
+    // Split the segment containing position, so that the splice point lies
+    // on a segment boundary
+    if (first < m_segments.size() && m_segments[first].offset < position) {
+        Segment tail = m_segments[first];
+        tail.begin += position - tail.offset;
+        m_segments[first].end = tail.begin;
+        m_segments.insert(m_segments.begin() + first + 1, tail);
+        first++;
+        updateOffsets(first);
+    }
+
+    // Drop or cut the segments covered by the erased range
+    auto last = first;
+
+    while (last < m_segments.size() && m_segments[last].offset < erase_end) {
+        auto &segment = m_segments[last];
+        const size_t length = segment.end - segment.begin;
+
+        if (segment.offset + length > erase_end) {
+            segment.begin += erase_end - segment.offset;
+            break;
+        }
+
+        last++;
+    }
+
+    m_segments.erase(m_segments.begin() + first, m_segments.begin() + last);
+
+    const size_t stream_end = min(end, tokens ? tokens->size() : 0);
+
+    if (begin < stream_end)
+        m_segments.insert(m_segments.begin() + first, {move(tokens), begin, stream_end, 0, origin});
+
+    updateOffsets(first);
+}
+
+void
+SplicedTokenStream::
+clear()
+{
+    m_segments.clear();
+    m_origins.clear();
+    m_size = 0;
+}
+
+size_t
+SplicedTokenStream::
+segmentOf(const size_t position) const
+{
+    if (position >= m_size)
+        return m_segments.size();
+
+    const auto it = upper_bound(m_segments.begin(), m_segments.end(), position,
+                                [](const size_t p, const Segment &segment) {
+                                    return p < segment.offset;
+                                });
+
+    return size_t(it - m_segments.begin()) - 1;
+}
+
+const AbstractTokenPtr &
+SplicedTokenStream::
+at(const size_t position) const
+{
+    const auto &segment = m_segments[segmentOf(position)];
+    return (*segment.tokens)[segment.begin + position - segment.offset];
+}
+
+uint32_t
+SplicedTokenStream::
+originOf(const size_t position) const
+{
+    const auto index = segmentOf(position);
+    return index < m_segments.size() ? m_segments[index].origin : uint32_t(NO_ORIGIN);
+}
+
+string
+SplicedTokenStream::
+originTrace(const size_t position) const
+{
+    auto index = originOf(position);
+
+    if (index == NO_ORIGIN)
+        return "";
+
+    const auto &token = at(position);
+    string trace = m_origins[index].name + ":" + to_string(token->row()) + ":" + to_string(token->column());
+
+    while (m_origins[index].parent != NO_ORIGIN) {
+        const auto &point = m_origins[index].expansion_point;
+        index = m_origins[index].parent;
+        trace += "\n  expanded from " + m_origins[index].name;
+
+        if (point)
+            trace += ":" + to_string(point->row()) + ":" + to_string(point->column());
+    }
+
+    return trace;
+}
+
+void
+SplicedTokenStream::
+updateOffsets(const size_t first_segment)
+{
+    size_t offset = first_segment ? m_segments[first_segment-1].offset
+                                    + m_segments[first_segment-1].end
+                                    - m_segments[first_segment-1].begin
+                                  : 0;
+
+    for (auto i = first_segment; i < m_segments.size(); i++) {
+        m_segments[i].offset = offset;
+        offset += m_segments[i].end - m_segments[i].begin;
+    }
+
+    m_size = offset;
+}
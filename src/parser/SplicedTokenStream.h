@@ -0,0 +1,149 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef SPLICEDTOKENSTREAM_H
+#define SPLICEDTOKENSTREAM_H
+#include "../tokenizer/AbstractTokenizer.h"
+#include <vector>
+
+namespace Abstract {
+namespace Parsing {
+using namespace std;
+using namespace Abstract::Tokenization;
+
+// Token stream composed of ranges of other token streams, e.g. the tokens of
+// included files or macro expansions spliced into the stream of the including
+// file. Ranges are referenced, never copied, so splicing costs
+// O(number of segments) regardless of the number of tokens involved.
+//
+// Every segment records its origin (the file or macro it stems from and the
+// token it was expanded at), which can be followed back for diagnostics.
+// Positions are global token indexes over the whole composite stream.
+class SplicedTokenStream
+{
+public:
+    enum : uint32_t { NO_ORIGIN = 0xFFFFFFFF };
+
+    struct Origin
+    {
+        string name;
+        uint32_t parent;
+        AbstractTokenPtr expansion_point;
+    };
+
+    struct Segment
+    {
+        AbstractTokenStreamPtr tokens;
+        size_t begin, end, offset;
+        uint32_t origin;
+    };
+
+    // Registers a source of tokens. expansion_point is the token of the parent
+    // origin which got replaced, e.g. the include directive or macro name.
+    uint32_t
+    addOrigin               (const string &name,
+                             const uint32_t parent = NO_ORIGIN,
+                             AbstractTokenPtr expansion_point = nullptr);
+
+    // Appends the tokens [begin, end) of the given stream
+    void
+    append                  (AbstractTokenStreamPtr tokens, const uint32_t origin,
+                             const size_t begin = 0, const size_t end = string::npos);
+
+    // Replaces erase_count tokens at position with the tokens [begin, end) of
+    // the given stream, splitting the affected segment if necessary
+    void
+    splice                  (const size_t position, const size_t erase_count,
+                             AbstractTokenStreamPtr tokens, const uint32_t origin,
+                             const size_t begin = 0, const size_t end = string::npos);
+
+    void
+    clear                   ();
+
+    inline size_t
+    size                    () const,
+    segmentCount            () const;
+
+    inline const Segment &
+    segment                 (const size_t index) const;
+
+    inline const Origin &
+    origin                  (const uint32_t index) const;
+
+    // Index of the segment containing the token at position, or segmentCount()
+    // for the end position
+    size_t
+    segmentOf               (const size_t position) const;
+
+    const AbstractTokenPtr &
+    at                      (const size_t position) const;
+
+    uint32_t
+    originOf                (const size_t position) const;
+
+    // "name:row:column", followed by one "expanded from name:row:column" line
+    // per enclosing origin
+    string
+    originTrace             (const size_t position) const;
+
+private:
+    void
+    updateOffsets           (const size_t first_segment);
+
+    vector<Segment> m_segments;
+    vector<Origin> m_origins;
+    size_t m_size {0};
+};
+
+using SplicedTokenStreamPtr = shared_ptr<const SplicedTokenStream>;
+
+inline size_t
+SplicedTokenStream::
+size() const
+{
+    return m_size;
+}
+
+inline size_t
+SplicedTokenStream::
+segmentCount() const
+{
+    return m_segments.size();
+}
+
+inline const SplicedTokenStream::Segment &
+SplicedTokenStream::
+segment(const size_t index) const
+{
+    return m_segments[index];
+}
+
+inline const SplicedTokenStream::Origin &
+SplicedTokenStream::
+origin(const uint32_t index) const
+{
+    return m_origins[index];
+}
+
+} // namespace Parsing
+} // namespace Abstract
+
+#endif // SPLICEDTOKENSTREAM_H
@@ -0,0 +1,126 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "StructuralIndex.h"
+#include <algorithm>
+using namespace Abstract::Parsing;
+
+StructuralIndex &
+StructuralIndex::
+addBrackets(const string &open, const string &close)
+{
+    ++m_pair_count;
+
+    for (const auto &entry : {make_pair(&open, true), make_pair(&close, false)}) {
+        if (entry.first->length() == 1)
+            m_by_char[uint8_t((*entry.first)[0])] = Bracket {m_pair_count, entry.second};
+        else
+            m_by_content[*entry.first] = Bracket {m_pair_count, entry.second};
+    }
+
+    return *this;
+}
+
+StructuralIndex &
+StructuralIndex::
+addBrackets(const uint16_t open_kind, const uint16_t close_kind)
+{
+    ++m_pair_count;
+
+    if (m_by_kind.size() <= max(open_kind, close_kind))
+        m_by_kind.resize(size_t(max(open_kind, close_kind)) + 1, Bracket {0, false});
+
+    m_by_kind[open_kind] = Bracket {m_pair_count, true};
+    m_by_kind[close_kind] = Bracket {m_pair_count, false};
+
+    return *this;
+}
+
+bool
+StructuralIndex::
+build(const AbstractTokenStream &tokens)
+{
+    begin(tokens.size());
+
+    for (size_t i = 0; i < tokens.size(); i++)
+        visit(*tokens[i], uint32_t(i));
+
+    finish();
+    return m_balanced;
+}
+
+bool
+StructuralIndex::
+build(const SplicedTokenStream &tokens)
+{
+    begin(tokens.size());
+
+    for (size_t s = 0; s < tokens.segmentCount(); s++) {
+        const auto &segment = tokens.segment(s);
+
+        for (auto i = segment.begin; i < segment.end; i++)
+            visit(*(*segment.tokens)[i], uint32_t(segment.offset + i - segment.begin));
+    }
+
+    finish();
+    return m_balanced;
+}
+
+void
+StructuralIndex::
+begin(const size_t token_count)
+{
+    m_match.assign(token_count, NO_MATCH);
+    m_open.clear();
+    m_balanced = true;
+}
+
+void
+StructuralIndex::
+visit(const AbstractToken &token, const uint32_t position)
+{
+    const auto b = bracket(token);
+
+    if (!b.pair)
+        return;
+
+    if (b.open) {
+        m_open.push_back({position, b.pair});
+        return;
+    }
+
+    // A closing bracket only matches the innermost open bracket of its pair,
+    // otherwise it stays unmatched and the open bracket remains pending
+    if (!m_open.empty() && m_open.back().pair == b.pair) {
+        m_match[m_open.back().position] = position;
+        m_open.pop_back();
+    }
+    else
+        m_balanced = false;
+}
+
+void
+StructuralIndex::
+finish()
+{
+    if (!m_open.empty())
+        m_balanced = false;
+}
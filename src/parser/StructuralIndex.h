@@ -0,0 +1,138 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef STRUCTURALINDEX_H
+#define STRUCTURALINDEX_H
+#include "SplicedTokenStream.h"
+#include <unordered_map>
+#include <vector>
+
+namespace Abstract {
+namespace Parsing {
+using namespace std;
+using namespace Abstract::Tokenization;
+
+// Side index of matching bracket tokens, built in one pass over a token
+// stream. For every opening bracket it stores the position of its closing
+// bracket, so AbstractParser::skipBalanced can jump over a whole block
+// without looking at the tokens inside.
+//
+// Bracket pairs are registered by token kind or by token content; a
+// registered kind takes precedence. Mismatched or unclosed brackets are left
+// without a match.
+class StructuralIndex
+{
+public:
+    enum : uint32_t { NO_MATCH = 0xFFFFFFFF };
+
+    StructuralIndex &
+    addBrackets             (const string &open, const string &close);
+
+    StructuralIndex &
+    addBrackets             (const uint16_t open_kind, const uint16_t close_kind);
+
+    // Returns false if the brackets of the stream are not balanced
+    bool
+    build                   (const AbstractTokenStream &tokens),
+    build                   (const SplicedTokenStream &tokens);
+
+    // Position of the bracket closing the one at position, or NO_MATCH
+    inline uint32_t
+    match                   (const size_t position) const;
+
+    inline bool
+    balanced                () const;
+
+private:
+    // Pairs are numbered from 1 in the order they were added; 0 means none
+    struct Bracket
+    {
+        uint32_t pair;
+        bool open;
+    };
+
+    struct OpenBracket
+    {
+        uint32_t position;
+        uint32_t pair;
+    };
+
+    inline Bracket
+    bracket                 (const AbstractToken &token) const;
+
+    void
+    begin                   (const size_t token_count),
+    visit                   (const AbstractToken &token, const uint32_t position),
+    finish                  ();
+
+    vector<Bracket> m_by_kind;
+    Bracket m_by_char[256] {};
+    unordered_map<string, Bracket> m_by_content;
+    uint32_t m_pair_count {0};
+
+    vector<uint32_t> m_match;
+    vector<OpenBracket> m_open;
+    bool m_balanced {true};
+};
+
+inline uint32_t
+StructuralIndex::
+match(const size_t position) const
+{
+    return position < m_match.size() ? m_match[position] : uint32_t(NO_MATCH);
+}
+
+inline bool
+StructuralIndex::
+balanced() const
+{
+    return m_balanced;
+}
+
+inline StructuralIndex::Bracket
+StructuralIndex::
+bracket(const AbstractToken &token) const
+{
+    if (token.kind() && token.kind() < m_by_kind.size() && m_by_kind[token.kind()].pair)
+        return m_by_kind[token.kind()];
+
+    if (!token.contentPtr())
+        return Bracket {0, false};
+
+    const auto &content = token.content();
+
+    if (content.length() == 1)
+        return m_by_char[uint8_t(content[0])];
+
+    if (!m_by_content.empty()) {
+        const auto iter = m_by_content.find(content);
+
+        if (iter != m_by_content.end())
+            return iter->second;
+    }
+
+    return Bracket {0, false};
+}
+
+} // namespace Parsing
+} // namespace Abstract
+
+#endif // STRUCTURALINDEX_H
@@ -0,0 +1,168 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef TOKENKINDSET_H
+#define TOKENKINDSET_H
+#include "../tokenizer/elements/AbstractToken.h"
+#include <bitset>
+#include <cassert>
+#include <vector>
+
+// Token kinds from 0 up to this bound can be used in FIRST sets. Set by the
+// ABSTRACTPARSER_MAX_TOKEN_KINDS CMake cache variable, which is passed on to
+// every target linking the library, as all of them must agree on it.
+#ifndef ABSTRACTPARSER_MAX_TOKEN_KINDS
+#define ABSTRACTPARSER_MAX_TOKEN_KINDS 256
+#endif
+
+static_assert(ABSTRACTPARSER_MAX_TOKEN_KINDS >= 1 && ABSTRACTPARSER_MAX_TOKEN_KINDS <= 65536,
+              "ABSTRACTPARSER_MAX_TOKEN_KINDS must be within the range of 16 bit token kinds");
+
+namespace Abstract {
+namespace Parsing {
+using namespace std;
+using namespace Abstract::Tokenization::Tokens;
+
+// Set of token kinds, e.g. the FIRST set of a grammar rule
+class TokenKindSet
+{
+public:
+    TokenKindSet() = default;
+
+    inline
+    TokenKindSet(const initializer_list<uint16_t> kinds);
+
+    // Kinds must be below ABSTRACTPARSER_MAX_TOKEN_KINDS; others trip an
+    // assertion and are ignored in release builds
+    inline TokenKindSet &
+    add                     (const uint16_t kind);
+
+    inline TokenKindSet &
+    add                     (const TokenKindSet &other);
+
+    inline bool
+    contains                (const uint16_t kind) const,
+    contains                (const AbstractToken &token) const,
+    intersects              (const TokenKindSet &other) const,
+    empty                   () const;
+
+private:
+    bitset<ABSTRACTPARSER_MAX_TOKEN_KINDS> m_kinds;
+};
+
+// Maps every token kind to the single alternative whose FIRST set contains
+// it, so the alternative to parse can be chosen with one table lookup
+class DispatchTable
+{
+public:
+    enum : int16_t { NO_ALTERNATIVE = -1, AMBIGUOUS = -2 };
+
+    inline explicit
+    DispatchTable(const initializer_list<TokenKindSet> first_sets);
+
+    inline int16_t
+    lookup                  (const uint16_t kind) const;
+
+private:
+    vector<int16_t> m_alternatives;
+};
+
+inline
+TokenKindSet::TokenKindSet(const initializer_list<uint16_t> kinds)
+{
+    for (const auto kind : kinds)
+        add(kind);
+}
+
+inline TokenKindSet &
+TokenKindSet::
+add(const uint16_t kind)
+{
+    assert(kind < ABSTRACTPARSER_MAX_TOKEN_KINDS && "token kind exceeds ABSTRACTPARSER_MAX_TOKEN_KINDS");
+
+    if (kind < ABSTRACTPARSER_MAX_TOKEN_KINDS)
+        m_kinds.set(kind);
+
+    return *this;
+}
+
+inline TokenKindSet &
+TokenKindSet::
+add(const TokenKindSet &other)
+{
+    m_kinds |= other.m_kinds;
+    return *this;
+}
+
+inline bool
+TokenKindSet::
+contains(const uint16_t kind) const
+{
+    return kind < ABSTRACTPARSER_MAX_TOKEN_KINDS && m_kinds[kind];
+}
+
+inline bool
+TokenKindSet::
+contains(const AbstractToken &token) const
+{
+    return contains(token.kind());
+}
+
+inline bool
+TokenKindSet::
+intersects(const TokenKindSet &other) const
+{
+    return (m_kinds & other.m_kinds).any();
+}
+
+inline bool
+TokenKindSet::
+empty() const
+{
+    return m_kinds.none();
+}
+
+inline
+DispatchTable::DispatchTable(const initializer_list<TokenKindSet> first_sets) :
+    m_alternatives(ABSTRACTPARSER_MAX_TOKEN_KINDS, NO_ALTERNATIVE)
+{
+    int16_t alternative = 0;
+
+    for (const auto &first_set : first_sets) {
+        for (uint32_t kind = 0; kind < ABSTRACTPARSER_MAX_TOKEN_KINDS; ++kind)
+            if (first_set.contains(uint16_t(kind)))
+                m_alternatives[kind] = m_alternatives[kind] == NO_ALTERNATIVE ? alternative : int16_t(AMBIGUOUS);
+
+        ++alternative;
+    }
+}
+
+inline int16_t
+DispatchTable::
+lookup(const uint16_t kind) const
+{
+    return kind < ABSTRACTPARSER_MAX_TOKEN_KINDS ? m_alternatives[kind] : int16_t(NO_ALTERNATIVE);
+}
+
+} // namespace Parsing
+} // namespace Abstract
+
+#endif // TOKENKINDSET_H
@@ -0,0 +1,166 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "Profiler.h"
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+using namespace Abstract::Profiling;
+
+namespace {
+
+mutex registry_mutex;
+vector<shared_ptr<ProfileCounters>> registry;
+
+shared_ptr<ProfileCounters>
+registerThread()
+{
+    const auto counters = make_shared<ProfileCounters>();
+
+    lock_guard<mutex> lock(registry_mutex);
+    registry.emplace_back(counters);
+
+    return counters;
+}
+
+void
+writeJsonString(stringstream &out, const string &str)
+{
+    out << '"';
+
+    for (const auto ch : str) {
+        if (ch == '"' || ch == '\\') out << '\\' << ch;
+        else if (uint8_t(ch) < 0x20) out << ' ';
+        else out << ch;
+    }
+
+    out << '"';
+}
+
+} // namespace
+
+void
+ProfileCounters::
+merge(const ProfileCounters &other)
+{
+    bytes_advanced           += other.bytes_advanced;
+    tokens_appended          += other.tokens_appended;
+    pos_starts_with_attempts += other.pos_starts_with_attempts;
+    pos_starts_with_hits     += other.pos_starts_with_hits;
+    positions_remembered     += other.positions_remembered;
+    positions_reset          += other.positions_reset;
+    tokens_rescanned         += other.tokens_rescanned;
+    predictions              += other.predictions;
+    prediction_failures      += other.prediction_failures;
+    prediction_ambiguities   += other.prediction_ambiguities;
+
+    Profiler::updateMax(max_backtrack_depth, other.max_backtrack_depth);
+
+    for (const auto &phase : other.phases) {
+        auto &timing = phases[phase.first];
+        timing.calls       += phase.second.calls;
+        timing.nanoseconds += phase.second.nanoseconds;
+    }
+}
+
+ProfileCounters &
+Profiler::
+counters()
+{
+    thread_local const shared_ptr<ProfileCounters> counters = registerThread();
+    return *counters;
+}
+
+ProfileCounters
+Profiler::
+aggregate()
+{
+    ProfileCounters result;
+
+    // Guards the registry only; the counters themselves are owned and
+    // written by their threads without locking
+    lock_guard<mutex> lock(registry_mutex);
+
+    for (const auto &counters : registry)
+        result.merge(*counters);
+
+    return result;
+}
+
+void
+Profiler::
+reset()
+{
+    lock_guard<mutex> lock(registry_mutex);
+
+    for (const auto &counters : registry)
+        *counters = ProfileCounters();
+}
+
+string
+Profiler::
+toJson(const ProfileCounters &counters)
+{
+    stringstream json;
+
+    json
+        << "{\"bytes_advanced\":"           << counters.bytes_advanced
+        << ",\"tokens_appended\":"          << counters.tokens_appended
+        << ",\"pos_starts_with_attempts\":" << counters.pos_starts_with_attempts
+        << ",\"pos_starts_with_hits\":"     << counters.pos_starts_with_hits
+        << ",\"positions_remembered\":"     << counters.positions_remembered
+        << ",\"positions_reset\":"          << counters.positions_reset
+        << ",\"tokens_rescanned\":"         << counters.tokens_rescanned
+        << ",\"max_backtrack_depth\":"      << counters.max_backtrack_depth
+        << ",\"predictions\":"              << counters.predictions
+        << ",\"prediction_failures\":"      << counters.prediction_failures
+        << ",\"prediction_ambiguities\":"   << counters.prediction_ambiguities
+        << ",\"phases\":{";
+
+    bool first = true;
+
+    for (const auto &phase : counters.phases) {
+        if (!first) json << ',';
+        first = false;
+
+        writeJsonString(json, phase.first);
+        json
+            << ":{\"calls\":"       << phase.second.calls
+            << ",\"nanoseconds\":"  << phase.second.nanoseconds
+            << '}';
+    }
+
+    json << "}}";
+
+    return json.str();
+}
+
+ScopedTimer::ScopedTimer(const string &phase) :
+    m_timing(Profiler::counters().phases[phase]),
+    m_begin(chrono::steady_clock::now()) {}
+
+ScopedTimer::~ScopedTimer()
+{
+    ++m_timing.calls;
+    m_timing.nanoseconds += uint64_t(chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now() - m_begin).count());
+}
@@ -0,0 +1,132 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef PROFILER_H
+#define PROFILER_H
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+// Opt-in instrumentation of the scanning and parsing hot paths. The counting
+// macros expand to nothing unless the library is configured with
+// ABSTRACTPARSER_PROFILING, so disabled builds carry no cost.
+#ifdef ABSTRACTPARSER_PROFILING
+#  define ABSTRACTPARSER_PROFILE_COUNT(counter, value) \
+    (::Abstract::Profiling::Profiler::counters().counter += uint64_t(value))
+#  define ABSTRACTPARSER_PROFILE_MAX(counter, value) \
+    (::Abstract::Profiling::Profiler::updateMax( \
+        ::Abstract::Profiling::Profiler::counters().counter, uint64_t(value)))
+#  define ABSTRACTPARSER_PROFILE_CONCAT_(a, b) a##b
+#  define ABSTRACTPARSER_PROFILE_CONCAT(a, b) ABSTRACTPARSER_PROFILE_CONCAT_(a, b)
+#  define ABSTRACTPARSER_PROFILE_SCOPE(phase) \
+    ::Abstract::Profiling::ScopedTimer ABSTRACTPARSER_PROFILE_CONCAT(profile_scope_, __LINE__)(phase)
+#else
+#  define ABSTRACTPARSER_PROFILE_COUNT(counter, value) ((void)0)
+#  define ABSTRACTPARSER_PROFILE_MAX(counter, value) ((void)0)
+#  define ABSTRACTPARSER_PROFILE_SCOPE(phase) ((void)0)
+#endif
+
+namespace Abstract {
+namespace Profiling {
+using namespace std;
+
+struct PhaseTiming
+{
+    uint64_t calls {0}, nanoseconds {0};
+};
+
+struct ProfileCounters
+{
+    uint64_t bytes_advanced {0},
+             tokens_appended {0},
+             pos_starts_with_attempts {0},
+             pos_starts_with_hits {0},
+             positions_remembered {0},
+             positions_reset {0},
+             tokens_rescanned {0},
+             max_backtrack_depth {0},
+             predictions {0},
+             prediction_failures {0},
+             prediction_ambiguities {0};
+
+    map<string, PhaseTiming> phases;
+
+    void
+    merge(const ProfileCounters &other);
+};
+
+class Profiler
+{
+public:
+    Profiler() = delete;
+
+    // Counters of the calling thread
+    static ProfileCounters &
+    counters();
+
+    // Sum of the counters of all threads which have been profiled so far,
+    // maxima are combined by taking the largest value. The counters of other
+    // threads are read without synchronization, so like reset() this must
+    // only be called while no profiled work is running, e.g. after joining
+    // the worker threads. counters() of the calling thread may be read at
+    // any time.
+    static ProfileCounters
+    aggregate();
+
+    // Must only be called while no profiled work is running
+    static void
+    reset();
+
+    static string
+    toJson(const ProfileCounters &counters);
+
+    static inline void
+    updateMax(uint64_t &current, const uint64_t value);
+};
+
+class ScopedTimer
+{
+public:
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    explicit
+    ScopedTimer(const string &phase);
+
+    ~ScopedTimer();
+
+private:
+    PhaseTiming &m_timing;
+    const chrono::steady_clock::time_point m_begin;
+};
+
+inline void
+Profiler::
+updateMax(uint64_t &current, const uint64_t value)
+{
+    if (value > current) current = value;
+}
+
+} // namespace Profiling
+} // namespace Abstract
+
+#endif // PROFILER_H
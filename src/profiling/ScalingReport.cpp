@@ -0,0 +1,140 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "ScalingReport.h"
+#include <map>
+#include <sstream>
+#include <unordered_set>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <sys/resource.h>
+#endif
+
+using namespace Abstract::Profiling;
+
+atomic<uint64_t> AllocationCounter::m_allocations {0};
+atomic<uint64_t> AllocationCounter::m_allocated_bytes {0};
+
+ScalingReport::ScalingReport(const double tolerance) :
+    m_tolerance(tolerance) {}
+
+void
+ScalingReport::
+addSample(const Sample &sample)
+{
+    m_samples.push_back(sample);
+}
+
+string
+ScalingReport::
+toCsv() const
+{
+    // Baseline sample per label: the one with the smallest input
+    map<string, const Sample *> baselines;
+
+    for (const auto &sample : m_samples) {
+        auto &baseline = baselines[sample.label];
+
+        if (sample.input_bytes && (!baseline || sample.input_bytes < baseline->input_bytes))
+            baseline = &sample;
+    }
+
+    stringstream out;
+    out << "label,input_bytes,token_count,seconds,mb_per_second,peak_rss_bytes,"
+           "allocations,allocations_per_token,token_memory_bytes,"
+           "token_memory_per_input_byte,superlinear\n";
+
+    for (const auto &sample : m_samples) {
+        const double bytes = double(sample.input_bytes ? sample.input_bytes : 1);
+        const double memory_ratio = double(sample.token_memory_bytes) / bytes;
+        string superlinear;
+
+        if (const auto baseline = baselines[sample.label]) {
+            const double base_bytes = double(baseline->input_bytes);
+
+            if (baseline->seconds > 0 && sample.seconds / bytes > m_tolerance * baseline->seconds / base_bytes)
+                superlinear = "time";
+
+            if (baseline->token_memory_bytes &&
+                memory_ratio > m_tolerance * double(baseline->token_memory_bytes) / base_bytes)
+                superlinear += superlinear.empty() ? "memory" : "+memory";
+        }
+
+        out << sample.label << ','
+            << sample.input_bytes << ','
+            << sample.token_count << ','
+            << sample.seconds << ','
+            << (sample.seconds > 0 ? double(sample.input_bytes) / 1e6 / sample.seconds : 0.0) << ','
+            << sample.peak_rss_bytes << ','
+            << sample.allocations << ','
+            << (sample.token_count ? double(sample.allocations) / double(sample.token_count) : 0.0) << ','
+            << sample.token_memory_bytes << ','
+            << memory_ratio << ','
+            << superlinear << '\n';
+    }
+
+    return out.str();
+}
+
+uint64_t
+ScalingReport::
+peakResidentSetSize()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage))
+        return 0;
+
+#  ifdef __APPLE__
+    return uint64_t(usage.ru_maxrss);
+#  else
+    return uint64_t(usage.ru_maxrss) * 1024;
+#  endif
+#else
+    return 0;
+#endif
+}
+
+uint64_t
+ScalingReport::
+tokenStreamMemory(const AbstractTokenStream &tokens)
+{
+    // Control block of a shared_ptr: vtable pointer and two reference counts
+    const uint64_t control_block = sizeof(void *) + 2 * sizeof(int32_t);
+
+    uint64_t memory = tokens.capacity() * sizeof(AbstractTokenPtr);
+    unordered_set<const string *> contents;
+
+    for (const auto &token : tokens) {
+        if (!token)
+            continue;
+
+        memory += sizeof(AbstractToken) + control_block;
+
+        const auto content = token->contentPtr().get();
+
+        if (content && contents.insert(content).second)
+            memory += sizeof(string) + control_block + content->capacity();
+    }
+
+    return memory;
+}
@@ -0,0 +1,225 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef SCALINGREPORT_H
+#define SCALINGREPORT_H
+#include "../tokenizer/AbstractTokenizer.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Place once at global scope in a benchmark program to count its heap
+// allocations through replaced global operator new/delete. All replaceable
+// forms are covered: plain, array, nothrow and, where the language
+// provides them, sized and aligned ones.
+#define ABSTRACTPARSER_COUNT_ALLOCATIONS \
+    void *operator new(std::size_t size) \
+    { \
+        ::Abstract::Profiling::AllocationCounter::count(size); \
+        if (void *ptr = std::malloc(size ? size : 1)) return ptr; \
+        throw std::bad_alloc(); \
+    } \
+    void *operator new[](std::size_t size) { return operator new(size); } \
+    void *operator new(std::size_t size, const std::nothrow_t &) noexcept \
+    { \
+        ::Abstract::Profiling::AllocationCounter::count(size); \
+        return std::malloc(size ? size : 1); \
+    } \
+    void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept { return operator new(size, tag); } \
+    void operator delete(void *ptr) noexcept { std::free(ptr); } \
+    void operator delete[](void *ptr) noexcept { std::free(ptr); } \
+    void operator delete(void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); } \
+    void operator delete[](void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); } \
+    ABSTRACTPARSER_COUNT_SIZED_DEALLOCATIONS \
+    ABSTRACTPARSER_COUNT_ALIGNED_ALLOCATIONS
+
+#if __cplusplus >= 201402L
+#  define ABSTRACTPARSER_COUNT_SIZED_DEALLOCATIONS \
+    void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); } \
+    void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+#else
+#  define ABSTRACTPARSER_COUNT_SIZED_DEALLOCATIONS
+#endif
+
+#ifdef __cpp_aligned_new
+#  define ABSTRACTPARSER_COUNT_ALIGNED_ALLOCATIONS \
+    void *operator new(std::size_t size, std::align_val_t alignment) \
+    { \
+        ::Abstract::Profiling::AllocationCounter::count(size); \
+        if (void *ptr = ::Abstract::Profiling::AllocationCounter::allocateAligned(size, std::size_t(alignment))) \
+            return ptr; \
+        throw std::bad_alloc(); \
+    } \
+    void *operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); } \
+    void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept \
+    { \
+        ::Abstract::Profiling::AllocationCounter::count(size); \
+        return ::Abstract::Profiling::AllocationCounter::allocateAligned(size, std::size_t(alignment)); \
+    } \
+    void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &tag) noexcept \
+    { \
+        return operator new(size, alignment, tag); \
+    } \
+    void operator delete(void *ptr, std::align_val_t) noexcept \
+    { \
+        ::Abstract::Profiling::AllocationCounter::freeAligned(ptr); \
+    } \
+    void operator delete[](void *ptr, std::align_val_t) noexcept \
+    { \
+        ::Abstract::Profiling::AllocationCounter::freeAligned(ptr); \
+    } \
+    void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept \
+    { \
+        ::Abstract::Profiling::AllocationCounter::freeAligned(ptr); \
+    } \
+    void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept \
+    { \
+        ::Abstract::Profiling::AllocationCounter::freeAligned(ptr); \
+    } \
+    void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept \
+    { \
+        ::Abstract::Profiling::AllocationCounter::freeAligned(ptr); \
+    } \
+    void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept \
+    { \
+        ::Abstract::Profiling::AllocationCounter::freeAligned(ptr); \
+    }
+#else
+#  define ABSTRACTPARSER_COUNT_ALIGNED_ALLOCATIONS
+#endif
+
+namespace Abstract {
+namespace Profiling {
+using namespace std;
+using namespace Abstract::Tokenization;
+
+class AllocationCounter
+{
+public:
+    AllocationCounter() = delete;
+
+    static inline void
+    count                   (const size_t size);
+
+    static inline uint64_t
+    allocations             (),
+    allocatedBytes          ();
+
+    // Over-aligned blocks for the aligned operator new, which keep the
+    // pointer returned by malloc in front of the aligned address
+    static inline void *
+    allocateAligned         (const size_t size, const size_t alignment);
+
+    static inline void
+    freeAligned             (void *ptr);
+
+private:
+    static atomic<uint64_t> m_allocations, m_allocated_bytes;
+};
+
+// Collects measurements of tokenizer/parser runs over inputs of growing size
+// and writes them as CSV. Within each label the smallest input is the
+// baseline; a sample whose time or token memory per input byte exceeds the
+// baseline by more than the tolerance factor is flagged as superlinear.
+class ScalingReport
+{
+public:
+    struct Sample
+    {
+        string label;
+        uint64_t input_bytes, token_count;
+        double seconds;
+        uint64_t peak_rss_bytes, allocations, token_memory_bytes;
+    };
+
+    explicit
+    ScalingReport(const double tolerance = 1.5);
+
+    void
+    addSample               (const Sample &sample);
+
+    string
+    toCsv                   () const;
+
+    // Peak resident set size of the process in bytes, 0 if unknown
+    static uint64_t
+    peakResidentSetSize     ();
+
+    // Estimated heap memory held by the stream: the pointer array, the
+    // tokens with their control blocks and the distinct content strings
+    static uint64_t
+    tokenStreamMemory       (const AbstractTokenStream &tokens);
+
+private:
+    double m_tolerance;
+    vector<Sample> m_samples;
+};
+
+inline void
+AllocationCounter::
+count(const size_t size)
+{
+    m_allocations.fetch_add(1, memory_order_relaxed);
+    m_allocated_bytes.fetch_add(size, memory_order_relaxed);
+}
+
+inline uint64_t
+AllocationCounter::
+allocations()
+{
+    return m_allocations.load(memory_order_relaxed);
+}
+
+inline uint64_t
+AllocationCounter::
+allocatedBytes()
+{
+    return m_allocated_bytes.load(memory_order_relaxed);
+}
+
+inline void *
+AllocationCounter::
+allocateAligned(const size_t size, const size_t alignment)
+{
+    void *block = malloc(size + alignment + sizeof(void *));
+
+    if (!block)
+        return nullptr;
+
+    const auto address = (uintptr_t(block) + sizeof(void *) + alignment - 1) & ~uintptr_t(alignment - 1);
+    reinterpret_cast<void **>(address)[-1] = block;
+
+    return reinterpret_cast<void *>(address);
+}
+
+inline void
+AllocationCounter::
+freeAligned(void *ptr)
+{
+    if (ptr)
+        free(static_cast<void **>(ptr)[-1]);
+}
+
+} // namespace Profiling
+} // namespace Abstract
+
+#endif // SCALINGREPORT_H
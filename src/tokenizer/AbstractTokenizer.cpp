@@ -20,32 +20,95 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 
 
 #include "AbstractTokenizer.h"
+#include "InputDecoder.h"
+#include "Lexer.h"
+#include "LineIndex.h"
+#include "AbstractTokenizerScanning.h"
+#include <cstring>
 using namespace Abstract::Tokenization;
 
 AbstractTokenizer::AbstractTokenizer(shared_ptr<string> content) :
     m_token_stream(make_shared<AbstractTokenStream>()),
-    m_content(move(content)), m_row(1), m_column(1),
-    m_iterator(m_content->begin()), m_row_begin(m_iterator) {}
+    m_content(move(content)), m_row(1), m_column(1)
+{
+    // The padding must not end up in a string the caller still uses
+    if (m_content.use_count() > 1) {
+        const auto shared_content = move(m_content);
+
+        m_content = make_shared<string>();
+        m_content->reserve(shared_content->length() + INPUT_PADDING);
+        m_content->assign(*shared_content);
+    }
+
+    padContent();
+}
 
 AbstractTokenizer::AbstractTokenizer(const string &content, const uint64_t begin_row, const uint64_t begin_column) :
     m_token_stream(make_shared<AbstractTokenStream>()),
-    m_content(make_shared<string>(content)),
-    m_row(begin_row), m_column(begin_column),
-    m_iterator(m_content->begin()), m_row_begin(m_iterator) {}
+    m_content(make_shared<string>()),
+    m_row(begin_row), m_column(begin_column)
+{
+    m_content->reserve(content.length() + INPUT_PADDING);
+    m_content->assign(content);
+    padContent();
+}
+
+void
+AbstractTokenizer::
+ownContent()
+{
+    if (m_content.use_count() <= 1)
+        return;
+
+    const auto position = getIterator() - m_content->begin(),
+               row_begin = m_row_begin - m_content->begin(),
+               end = m_end - m_content->begin();
+
+    m_content = make_shared<string>(*m_content);
+    m_iterator = m_content->begin() + position;
+    m_row_begin = m_content->begin() + row_begin;
+    m_end = m_content->begin() + end;
+}
+
+void
+AbstractTokenizer::
+padContent(const size_t offset)
+{
+    const auto length = m_content->length();
+
+    m_content->append(INPUT_PADDING, '\0');
+    m_end = m_content->begin() + int64_t(length);
+    m_iterator = m_row_begin = m_content->begin() + int64_t(offset);
+    m_token_begin = inputOffset();
+}
 
 bool
 AbstractTokenizer::
 isComment(const string &comment_start_identifier, const string &comment_end_identifier, string &comment) const
+{
+    CharSpan span;
+
+    if (isComment(comment_start_identifier, comment_end_identifier, span)) {
+        span.assignTo(comment);
+        return true;
+    }
+
+    return false;
+}
+
+bool
+AbstractTokenizer::
+isComment(const string &comment_start_identifier, const string &comment_end_identifier, CharSpan &comment) const
 {
     if (posStartsWith(comment_start_identifier)) {
         advance(+int64_t(comment_start_identifier.length()));
         const auto begin = getIterator();
 
-        while (!isEof() && !(currentChar(comment_end_identifier.front()) &&
-               posStartsWith(comment_end_identifier)) && advance());
+        while (!(currentChar(comment_end_identifier.front()) &&
+               posStartsWith(comment_end_identifier)) && !isEndSentinel() && advance());
 
         if (posStartsWith(comment_end_identifier)) {
-            comment = string(begin, getIterator());
+            comment = CharSpan(begin, getIterator());
             advance(+int64_t(comment_end_identifier.length()));
             return true;
         }
@@ -56,137 +119,215 @@ isComment(const string &comment_start_identifier, const string &comment_end_iden
 
 bool
 AbstractTokenizer::
-isTerm(string *str) const
+normalizeEncoding()
 {
-    if (bool(isalpha(currentChar()))) {
-        string term;
-
-        term = currentChar();
-        advance();
-
-        while (!isEof()) {
-            if (bool(isalpha(currentChar())) || bool(isdigit(currentChar())) || currentChar('-') || currentChar('_')) {
-                term += currentChar();
-                advance();
-            }
-            else {
-                if (term.empty()) break;
-                if (str != nullptr) *str = term;
-
-                return true;
-            }
-        }
-    }
+    size_t bom_length;
 
-    return false;
-}
+    // Detect without the padding, whose NUL bytes would hide the zero byte
+    // pattern of short UTF-16 input
+    ownContent();
+    m_content->resize(inputLength());
 
-void
-AbstractTokenizer::
-skipSpace() const noexcept
-{
-    while (!isEof() && isSpaceChar() && advance());
+    return normalizeEncoding(InputDecoder::detectEncoding(*m_content, bom_length));
 }
 
 bool
 AbstractTokenizer::
-posStartsWith(const string &s, const bool case_insensitive) const
+normalizeEncoding(const Encoding source_encoding)
 {
-    if (m_content->length() > s.length()) {
-        if (case_insensitive) {
-            return search(getIterator(), getIterator(+std::distance(s.begin(), s.end())),
-                s.begin(), s.end(), [](char ch1, char ch2) {
-                return tolower(ch1) == tolower(ch2);}) == getIterator();
+    size_t bom_length;
+    ownContent();
+    m_content->resize(inputLength());
+
+    if (InputDecoder::detectEncoding(*m_content, bom_length) != source_encoding)
+        bom_length = 0;
+
+    if (source_encoding == UTF8)
+        padContent(bom_length);
+    else {
+        auto content = make_shared<string>();
+
+        if (!InputDecoder::toUtf8(*m_content, source_encoding, *content, bom_length)) {
+            padContent();
+            return false;
         }
 
-        return search(getIterator(), getIterator(+std::distance(s.begin(), s.end())),
-            s.begin(), s.end()) == getIterator();
+        m_content = move(content);
+        padContent();
     }
 
-    return false;
+    m_encoding = UTF8;
+
+    return true;
 }
 
-bool
+void
 AbstractTokenizer::
-posStartsWith(const DataContainer<string> &string_list, const bool case_insensitive) const
+reset(const string &content, const uint64_t begin_row, const uint64_t begin_column)
 {
-    for (const auto &s : string_list)
-        if (posStartsWith(s, case_insensitive))
-            return true;
-
-    return false;
+    // Never overwrite a byte stream which was handed in by the caller
+    if (m_content.use_count() > 1)
+        m_content = make_shared<string>(content);
+    else
+        m_content->assign(content);
+
+    padContent();
+    m_token_stream->clear();
+
+    m_row = begin_row;
+    m_column = begin_column;
+    m_dropped_input = 0;
+    m_token_begin = 0;
+    m_pending_input = 0;
+
+    if (m_lexer_memo)
+        m_lexer_memo->clear();
+
+    m_syntax_error = false;
+    m_input_complete = true;
+    m_error_message.clear();
 }
 
-bool
+AbstractTokenizer::FeedResult
 AbstractTokenizer::
-isString(string &str) const
+feed(const string &chunk, const bool last_chunk)
 {
-    if (currentChar({'"', '\''})) {
+    if (syntaxError())
+        return FAILED;
+
+    ownContent();
+
+    auto offset = size_t(getIterator() - m_content->begin());
+    m_content->resize(inputLength());
+
+    // Drop consumed input once it makes up most of the buffer
+    if (offset > m_content->length() / 2) {
+        m_content->erase(0, offset);
+        m_dropped_input += offset;
+        offset = 0;
+    }
+
+    m_content->append(chunk);
+    padContent(offset);
+    m_input_complete = last_chunk;
+
+    if (!last_chunk && inputLength() - offset < 2 * m_pending_input)
+        return NEED_MORE_INPUT;
+
+    m_pending_input = 0;
+
+    while (!isEof()) {
         const auto begin = getIterator();
+        const auto row = m_row, column = m_column;
+        const auto token_begin = m_token_begin;
+        const auto token_count = tokenStream()->size();
+
+        const auto scanned = tokenizeNext();
+
+        if (!last_chunk && (isEof() || !scanned)) {
+            if (!scanned && !isEof())
+                return FAILED;
+
+            tokenStream()->erase(tokenStream()->begin() + int64_t(token_count), tokenStream()->end());
+            m_pending_input = size_t(inputEnd() - begin);
+            m_iterator = begin;
+            m_row = row;
+            m_column = column;
+            m_token_begin = token_begin;
+            m_syntax_error = false;
+            m_error_message.clear();
+
+            return NEED_MORE_INPUT;
+        }
 
-        do advance(); while (!isEof() && !currentChar(*begin));
+        if (!scanned)
+            return FAILED;
 
-        if (currentChar(*begin) && advance()) {
-            str = string(begin, getIterator());
-            return true;
+        if (getIterator() == begin) {
+            throwSyntaxError();
+            return FAILED;
         }
     }
 
-    return false;
+    return last_chunk ? FINISHED : NEED_MORE_INPUT;
 }
 
 bool
 AbstractTokenizer::
-isOneOfChars(const string::iterator iter, const string &allowed) const
+tokenizeNext()
 {
-    return find(allowed.begin(), allowed.end(), *iter) != allowed.end();
+    m_error_message = "Resumable tokenization requires an implementation of tokenizeNext()";
+    setSyntaxError();
+
+    return false;
 }
 
 bool
 AbstractTokenizer::
-isCharOfRange(char from_char, char to_char) const
+tokenize(const Lexer &lexer)
 {
-    return currentChar() >= from_char && currentChar() <= to_char;
+    while (!isEof())
+        if (!scanToken(lexer))
+            return false;
+
+    return true;
 }
 
-string
+bool
 AbstractTokenizer::
-readCharSequence(const string &not_allowed_chars) const
+scanToken(const Lexer &lexer)
 {
-    string char_sequence;
+    if (!lexer.isValid()) {
+        m_error_message = lexer.errorMessage();
+        setSyntaxError();
+        return false;
+    }
+
+    int32_t rule;
+    bool at_end;
+    const auto begin = getIterator();
+    if (!m_lexer_memo)
+        m_lexer_memo = make_shared<LexerMemo>();
+
+    const auto length = lexer.match(&*begin, &*inputEnd(), rule, at_end, *m_lexer_memo, inputOffset(), inputComplete());
 
-    while (!isEof() && !isOneOfChars(not_allowed_chars)) {
-        char_sequence += currentChar();
-        advance();
+    // A longer match may follow with the next chunk
+    if (at_end && !inputComplete()) {
+        m_iterator = inputEnd();
+        return true;
     }
 
-    return char_sequence;
-}
+    if (!length) {
+        throwSyntaxError();
+        return false;
+    }
 
-bool
-AbstractTokenizer::
-advance(int64_t count) const
-{
-    if ((count < 0 && getIterator(+count) < byteStream()->begin()) || getIterator(+count) > byteStream()->end()) return false;
+    const auto row = m_row, column = m_column;
+    const auto offset = inputOffset();
+    advance(int64_t(length));
 
-    if (count > 0) {
-        auto end = getIterator(+count);
+    const auto &matched_rule = lexer.specification().rules()[size_t(rule)];
 
-        while (getIterator() < end) {
-            if (m_encoding == UTF8 && isUtf8MultibyteChar())
-                continue;
+    if (matched_rule.skip)
+        return true;
 
-            if (!isEof() && (isTab() || isLineTerminator() || ++m_column))
-                ++m_iterator;
-        }
-    } else if (count < 0) {
-        if (getIterator()+count > byteStream()->begin()) m_iterator+=count;
-        else return false;
-    }
+    const CharSpan match(begin, getIterator());
+    const auto token = matched_rule.factory ?
+        matched_rule.factory(match) : make_shared<AbstractToken>(match.toString());
+
+    token->setKind(matched_rule.kind);
+    appendToken(token, row, column, offset);
 
     return true;
 }
 
+LineIndex
+AbstractTokenizer::
+lineIndex() const
+{
+    return LineIndex(m_content->begin(), inputEnd(), m_line_endings);
+}
+
 void
 AbstractTokenizer::
 throwSyntaxError(const string &message)
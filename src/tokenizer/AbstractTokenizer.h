@@ -23,6 +23,8 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #define ABSTRACTTOKENIZER_H
 #include "../../../StringLibrary/src/String.h"
 #include "elements/AbstractToken.h"
+#include "UnicodeIdentifier.h"
+#include "../profiling/Profiler.h"
 #include <memory>
 
 namespace Abstract {
@@ -30,20 +32,73 @@ namespace Tokenization {
 using namespace Abstract::Tokenization::Tokens;
 using AbstractTokenStream    = DataContainer<AbstractTokenPtr>;
 using AbstractTokenStreamPtr = shared_ptr<AbstractTokenStream>;
+using ConstAbstractTokenStreamPtr = shared_ptr<const AbstractTokenStream>;
+
+class KeywordSet;
+class Lexer;
+class LexerMemo;
+class LineIndex;
+
+// Non-owning view of a character sequence inside the byte stream of a
+// tokenizer. It stays valid as long as the byte stream is not modified.
+class CharSpan
+{
+public:
+    CharSpan() = default;
+
+    inline
+    CharSpan(const string::iterator begin, const string::iterator end);
+
+    inline string::iterator
+    begin                   () const,
+    end                     () const;
+
+    inline size_t
+    length                  () const;
+
+    inline bool
+    empty                   () const,
+    equals                  (const string &str) const;
+
+    inline string
+    toString                () const;
+
+    // Reuses the capacity of the given buffer
+    inline void
+    assignTo                (string &buffer) const;
+
+private:
+    string::iterator m_begin, m_end;
+};
 
 class AbstractTokenizer
 {
 public:
+    enum Encoding : uint8_t { UNSUPPORTED, UTF8, ISO8859, WINDOWS125X, UTF16LE, UTF16BE };
+    enum FeedResult : uint8_t { NEED_MORE_INPUT, FINISHED, FAILED };
+
+    // Line ending policy, a combination of these flags. UNICODE_LS_PS adds
+    // the UTF-8 encoded line and paragraph separators U+2028 and U+2029.
+    enum LineEnding : uint8_t { LF = 1, CR = 2, CRLF = 4, UNICODE_LS_PS = 8 };
+
+    // Number of NUL bytes which always follow the end of input in the byte
+    // stream. Scanning loops may read up to this far past the end and only
+    // need to check for the end of input when they meet a NUL byte.
+    enum : uint8_t { INPUT_PADDING = 64 };
+
     AbstractTokenizer(AbstractTokenizer &) = delete;
     AbstractTokenizer(const AbstractTokenizer &) = delete;
     AbstractTokenizer(AbstractTokenizer &&) = delete;
     AbstractTokenizer(const AbstractTokenizer &&) = delete;
 
+    // Content which is still referenced elsewhere is copied, as the
+    // tokenizer pads and modifies its byte stream; handing over the only
+    // reference avoids the copy
     explicit
     AbstractTokenizer(shared_ptr<string> content),
     AbstractTokenizer(const string &content, const uint64_t begin_row = 1, const uint64_t begin_column = 1);
 
-    ~AbstractTokenizer() = default;
+    virtual ~AbstractTokenizer() = default;
 
     AbstractTokenizer &operator=(AbstractTokenizer &) = delete;
     AbstractTokenizer &operator=(const AbstractTokenizer &) = delete;
@@ -53,8 +108,32 @@ public:
     const string &
     errorMessage            ();
 
+    // Resumable tokenization of input which arrives in pieces. Appends the
+    // chunk to the byte stream and calls tokenizeNext() until the input is
+    // exhausted. A token which reaches the end of a chunk that is not the
+    // last one is discarded and scanned again once more input has been fed,
+    // so no scanning state has to survive between calls. The rescan is
+    // deferred until the pending input has at least doubled since the scan
+    // ran out of input, which keeps the total work for long tokens linear.
+    // Consumed input is dropped from the byte stream.
+    FeedResult
+    feed                    (const string &chunk, const bool last_chunk = false);
+
+    // Prepares the tokenizer for the next document while keeping the
+    // capacity of the byte stream, the token stream and the error message.
+    // The token stream is cleared in place, so a parser working on it has
+    // to be reset as well.
+    void
+    reset                   (const string &content,
+                             const uint64_t begin_row = 1,
+                             const uint64_t begin_column = 1);
+
 protected:
-    enum Encoding : uint8_t { UNSUPPORTED, UTF8, ISO8859, WINDOWS125X };
+    // Scans a single token at the current position in resumable mode.
+    // Returns false on a syntax error; when it runs out of input it has to
+    // leave the position at the end of the byte stream.
+    virtual bool
+    tokenizeNext            ();
 
     inline void
     setEncoding             (Encoding encoding);
@@ -66,26 +145,70 @@ protected:
     isOneOfChars            (const string &allowed) const,
     isSpaceChar             () const noexcept,
 
+    // False while feed() is waiting for further chunks
+    inputComplete           () const,
+
     encoding                (const initializer_list<Encoding> candidates) const;
 
     void
     skipSpace               () const noexcept;
 
+    // Transcode the byte stream to UTF-8 and skip a byte order mark.
+    // Must be called before scanning starts, as it resets the position.
+    bool
+    normalizeEncoding       (),
+    normalizeEncoding       (const Encoding source_encoding);
+
+    // Single pass maximal munch scan of the remaining input with the DFA of
+    // the given lexer, appending a token for every match of a non-skip rule.
+    // Dead ends of the DFA are remembered until reset(), so the scan takes
+    // linear time even where longest matches have to back up.
+    bool
+    tokenize                (const Lexer &lexer),
+
+    // Scans one token with the DFA of the given lexer
+    scanToken               (const Lexer &lexer);
+
+    // Line index of the input held in the byte stream according to the line
+    // ending policy. Once feed() has dropped consumed input, its offsets and
+    // lines start at the beginning of the byte stream, while token offsets
+    // count from the beginning of the whole input: subtract droppedInput()
+    // from a token offset before looking it up.
+    LineIndex
+    lineIndex               () const;
+
+    // Length in bytes of the character at the current position if it can
+    // start (or continue) a term, 0 otherwise
+    inline uint8_t
+    termCharLength          (const bool is_start) const;
+
     inline bool
     isLineTerminator        () const,
     isTab                   () const,
     isUtf8MultibyteChar     () const,
 
+    // True if the current character is the padding after the end of input
+    isEndSentinel           () const,
+
     syntaxError             () const;
 
-    bool
-    advance                 (int64_t count = 1) const,
+    // Moves by count bytes, keeping row and column up to date. Single steps
+    // over printable ASCII are handled inline.
+    inline bool
+    advance                 (int64_t count = 1) const;
 
+    bool
     isComment               (const string &comment_start_identifier,
                              const string &comment_end_identifier,
                              string &comment) const,
+    isComment               (const string &comment_start_identifier,
+                             const string &comment_end_identifier,
+                             CharSpan &comment) const,
     isString                (string &str) const,
+    isString                (CharSpan &str) const,
     isTerm                  (string *str = nullptr) const,
+    isTerm                  (CharSpan &term) const,
+    readCharSequence        (const string &not_allowed_chars, CharSpan &char_sequence) const,
 
     isCharOfRange           (char from_char, char to_char) const,
 
@@ -93,14 +216,28 @@ protected:
                              const bool case_insensitive = false) const,
     posStartsWith           (const DataContainer<string> &string_list,
                              const bool case_insensitive = false) const,
+
+    // Consumes the longest keyword of the set at the current position,
+    // unless it ends in a term character and the term continues after it
+    isKeyword               (const KeywordSet &keywords, CharSpan &keyword) const,
+
     isOneOfChars            (const string::iterator iter, const string &allowed) const;
 
     string
     readCharSequence        (const string &not_allowed_chars) const;
 
+    // Called with the position behind the source text of the token, which
+    // ends at the current position. Without an explicit offset the token is
+    // taken to start where the previous token ended, or behind the space
+    // skipped by skipSpace() after it, so delimiters left out of the content
+    // (e.g. comment markers or quotes) are part of its source range. Input
+    // skipped in other ways is then included as well; pass the offset of
+    // the token start where that matters.
     inline void
     appendToken             (const AbstractTokenPtr &token),
     appendToken             (const AbstractTokenPtr &token, const uint64_t row, const uint64_t column),
+    appendToken             (const AbstractTokenPtr &token, const uint64_t row, const uint64_t column,
+                             const uint64_t offset),
     setIterator             (const string::iterator iterator) const,
 
     setSyntaxError          ();
@@ -123,37 +260,134 @@ protected:
 
     inline uint64_t
     currentRow              () const,
-    currentColumn           () const;
+    currentColumn           () const,
 
+    // Byte offset of the current position in the whole input, including
+    // input already dropped by feed()
+    inputOffset             () const,
+
+    // Bytes of input dropped by feed(), i.e. the offset of the beginning of
+    // the byte stream in the whole input
+    droppedInput            () const;
+
+    // The byte stream including INPUT_PADDING trailing NUL bytes
     inline const shared_ptr<string>
     byteStream              () const;
 
+    inline const string::iterator
+    inputEnd                () const;
+
+    inline size_t
+    inputLength             () const;
+
     inline const AbstractTokenStreamPtr
     tokenStream             () const;
 
     inline void
-    setTabWidth             (const uint8_t tab_width);
+    setTabWidth             (const uint8_t tab_width),
+    setLineEndings          (const uint8_t line_endings);
 
     inline uint8_t
-    getTabWidth             ();
+    getTabWidth             (),
+    lineEndings             () const;
 
     void
     throwSyntaxError        (const string &message = "");
 
 private:
+    bool
+    advanceSlowPath         (int64_t count) const;
+
+    // Replaces the byte stream by a private copy while it is shared, e.g.
+    // with the caller who handed it in or via byteStream(), before it is
+    // modified in place
+    void
+    ownContent              ();
+
+    // Appends the sentinel padding to the byte stream and sets the position
+    void
+    padContent              (const size_t offset = 0);
+
     AbstractTokenStreamPtr      m_token_stream;
 	shared_ptr<string>			m_content;
 
     mutable uint64_t			m_row, m_column;
     mutable string::iterator	m_iterator, m_row_begin;
+    string::iterator            m_end;
+    uint64_t                    m_dropped_input {0};
+
+    // Offset at which a token appended without an explicit offset starts
+    mutable uint64_t            m_token_begin {0};
 
     Encoding m_encoding { UTF8 };
     uint8_t m_tab_width = 4;
+    uint8_t m_line_endings = LF | CRLF;
 
     bool m_syntax_error {false};
+    bool m_input_complete {true};
+
+    // Bytes from the start of a token which ran out of input to the end of
+    // input at that time; feed() waits for twice as many before rescanning
+    size_t m_pending_input {0};
     string m_error_message;
+
+    // Dead ends of the lexer DFA met by scanToken() in the current input
+    shared_ptr<LexerMemo> m_lexer_memo;
 };
 
+inline
+CharSpan::CharSpan(const string::iterator begin, const string::iterator end) :
+    m_begin(begin), m_end(end) {}
+
+inline string::iterator
+CharSpan::
+begin() const
+{
+    return m_begin;
+}
+
+inline string::iterator
+CharSpan::
+end() const
+{
+    return m_end;
+}
+
+inline size_t
+CharSpan::
+length() const
+{
+    return size_t(m_end - m_begin);
+}
+
+inline bool
+CharSpan::
+empty() const
+{
+    return m_begin == m_end;
+}
+
+inline bool
+CharSpan::
+equals(const string &str) const
+{
+    return length() == str.length() && std::equal(m_begin, m_end, str.begin());
+}
+
+inline string
+CharSpan::
+toString() const
+{
+    return string(m_begin, m_end);
+}
+
+inline void
+CharSpan::
+assignTo(string &buffer) const
+{
+    buffer.assign(m_begin, m_end);
+}
+
 inline void
 AbstractTokenizer::
 setEncoding(Encoding encoding)
@@ -194,22 +428,47 @@ getTabWidth()
     return m_tab_width;
 }
 
+inline void
+AbstractTokenizer::
+setLineEndings(const uint8_t line_endings)
+{
+    m_line_endings = line_endings;
+}
+
+inline uint8_t
+AbstractTokenizer::
+lineEndings() const
+{
+    return m_line_endings;
+}
+
 inline void
 AbstractTokenizer::
 appendToken(const AbstractTokenPtr &token)
 {
-    token->setRow(m_row);
-    token->setColumn(m_column - (token->contentPtr() ? token->content().length() + 1 : 0));
-    tokenStream()->emplace_back(token);
+    appendToken(token, m_row, m_column - (token->contentPtr() ? token->content().length() + 1 : 0),
+                m_token_begin);
 }
 
 inline void
 AbstractTokenizer::
 appendToken(const AbstractTokenPtr &token, const uint64_t row, const uint64_t column)
+{
+    appendToken(token, row, column, m_token_begin);
+}
+
+inline void
+AbstractTokenizer::
+appendToken(const AbstractTokenPtr &token, const uint64_t row, const uint64_t column,
+            const uint64_t offset)
 {
     token->setRow(row);
     token->setColumn(column);
+    token->setOffset(offset);
+    token->setSourceLength(inputOffset() > offset ? inputOffset() - offset : 0);
     tokenStream()->emplace_back(token);
+    m_token_begin = inputOffset();
+    ABSTRACTPARSER_PROFILE_COUNT(tokens_appended, 1);
 }
 
 inline bool
@@ -234,18 +493,16 @@ isUtf8MultibyteChar() const
     }
 
     if (bool(char_count)) {
-        const auto begin = getIterator();
-        const auto end = begin + char_count;
-
-        while (!isEof() && getIterator() != end) {
-            if (currentChar() < 0)
-                ++m_iterator;
-            else {
-                m_iterator = begin;
+        const auto end = getIterator() + char_count;
+
+        // Only continuation bytes (10xxxxxx) may follow, so a separator like
+        // U+2028 is never swallowed by a stray lead byte. A truncated
+        // character at the end of input stops at the padding.
+        for (auto pos = getIterator() + 1; pos != end; ++pos)
+            if ((*pos & 0xc0) != 0x80)
                 return false;
-            }
-        }
 
+        m_iterator = end;
         ++m_column;
         return true;
     }
@@ -340,18 +597,76 @@ inline bool
 AbstractTokenizer::
 isSpaceChar() const noexcept
 {
-    return bool(isspace(currentChar()));
+    // isspace() of the C locale, without the library call
+    const auto ch = uint8_t(currentChar());
+    return ch == ' ' || uint8_t(ch - '\t') <= '\r' - '\t';
 }
 
 inline bool
 AbstractTokenizer::
-isLineTerminator() const
+advance(int64_t count) const
 {
-    if (currentChar('\n')) {
-        ++m_row; m_column = 1;
+    if (count == 1 && m_iterator < m_end && uint8_t(*m_iterator - 0x20) < 0x5F) {
+        ABSTRACTPARSER_PROFILE_COUNT(bytes_advanced, 1);
+        ++m_iterator;
+        ++m_column;
         return true;
     }
-    return false;
+
+    return advanceSlowPath(count);
+}
+
+inline uint8_t
+AbstractTokenizer::
+termCharLength(const bool is_start) const
+{
+    const auto ch = currentChar();
+
+    if (UnicodeIdentifier::asciiClass(ch) &
+        (is_start ? UnicodeIdentifier::ASCII_START : UnicodeIdentifier::ASCII_CONTINUE))
+        return 1;
+
+    if (uint8_t(ch) < 0x80 || m_encoding != UTF8)
+        return 0;
+
+    uint32_t code_point;
+    const auto remaining = inputEnd() - getIterator();
+    const auto length = UnicodeIdentifier::decodeUtf8(&*getIterator(), &*inputEnd(), code_point);
+
+    // The character may be completed by the next chunk
+    if (!length && !m_input_complete && remaining < 4)
+        return uint8_t(remaining);
+
+    return length && (is_start ? UnicodeIdentifier::isStart(code_point) :
+                                 UnicodeIdentifier::isContinue(code_point)) ? length : 0;
+}
+
+inline bool
+AbstractTokenizer::
+isLineTerminator() const
+{
+    switch (currentChar()) {
+    case '\n':
+        if (!(m_line_endings & LF) &&
+            !(m_line_endings & CRLF && getIterator() != m_content->begin() && prevChar('\r')))
+            return false;
+        break;
+
+    case '\r':
+        // Counted together with the following '\n'
+        if (m_line_endings & CRLF && nextChar('\n'))
+            return true;
+
+        if (!(m_line_endings & CR))
+            return false;
+        break;
+
+    default:
+        return false;
+    }
+
+    ++m_row; m_column = 1;
+    return true;
 }
 
 inline bool
@@ -365,7 +680,14 @@ inline bool
 AbstractTokenizer::
 isEof(const uint64_t count) const
 {
-    return getIterator(int64_t(count)) == byteStream()->end();
+    return getIterator(int64_t(count)) >= m_end;
+}
+
+inline bool
+AbstractTokenizer::
+isEndSentinel() const
+{
+    return currentChar('\0') && isEof();
 }
 
 inline uint64_t
@@ -382,6 +704,20 @@ currentColumn() const
     return m_column;
 }
 
+inline uint64_t
+AbstractTokenizer::
+inputOffset() const
+{
+    return m_dropped_input + uint64_t(m_iterator - m_content->begin());
+}
+
+inline uint64_t
+AbstractTokenizer::
+droppedInput() const
+{
+    return m_dropped_input;
+}
+
 inline const shared_ptr<string>
 AbstractTokenizer::
 byteStream() const
@@ -389,6 +725,20 @@ byteStream() const
     return m_content;
 }
 
+inline const string::iterator
+AbstractTokenizer::
+inputEnd() const
+{
+    return m_end;
+}
+
+inline size_t
+AbstractTokenizer::
+inputLength() const
+{
+    return size_t(m_end - m_content->begin());
+}
+
 inline const AbstractTokenStreamPtr
 AbstractTokenizer::
 tokenStream() const
@@ -403,6 +753,13 @@ setSyntaxError()
     m_syntax_error = true;
 }
 
+inline bool
+AbstractTokenizer::
+inputComplete() const
+{
+    return m_input_complete;
+}
+
 inline bool
 AbstractTokenizer::
 syntaxError() const
@@ -420,4 +777,8 @@ errorMessage()
 } // namespace Tokenization
 } // namespace Abstract
 
+#ifdef ABSTRACTPARSER_INLINE_SCANNING
+#include "AbstractTokenizerScanning.h"
+#endif
+
 #endif // ABSTRACTTOKENIZER_H
@@ -0,0 +1,288 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef ABSTRACTTOKENIZERSCANNING_H
+#define ABSTRACTTOKENIZERSCANNING_H
+#include "AbstractTokenizer.h"
+#include "KeywordSet.h"
+#include <algorithm>
+#include <cstring>
+
+// Definitions of the scanning primitives used in the inner loops of
+// tokenizers (skipSpace, isTerm, isString, posStartsWith, ...). They are
+// compiled into the library by default; with ABSTRACTPARSER_INLINE_SCANNING
+// they are included by AbstractTokenizer.h as inline functions, so they can
+// be inlined into derived tokenizers compiled outside the library. The rest
+// of the library is built and linked as usual, and tokenizers inside it
+// (e.g. the lexer driven scanToken) are not affected.
+#ifdef ABSTRACTPARSER_INLINE_SCANNING
+#  define ABSTRACTPARSER_SCANNING_INLINE inline
+#else
+#  define ABSTRACTPARSER_SCANNING_INLINE
+#endif
+
+namespace Abstract {
+namespace Tokenization {
+namespace Scanning {
+
+const uint64_t ONES      = 0x0101010101010101ULL;
+const uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+inline bool
+hasByte(const uint64_t word, const uint8_t byte)
+{
+    const auto x = word ^ (ONES * byte);
+    return (x - ONES) & ~x & HIGH_BITS;
+}
+
+// Length of the run of ASCII bytes in [begin, end) which only move the
+// column by one, i.e. all but tab, LF and CR, in steps of 8 bytes
+inline int64_t
+plainAsciiRun(const string::iterator begin, const string::iterator end)
+{
+    auto pos = begin;
+
+    while (end - pos >= 8) {
+        uint64_t word;
+        memcpy(&word, &*pos, sizeof(word));
+
+        if ((word & HIGH_BITS) || hasByte(word, '\t') || hasByte(word, '\n') || hasByte(word, '\r'))
+            break;
+
+        pos += 8;
+    }
+
+    return pos - begin;
+}
+
+} // namespace Scanning
+
+ABSTRACTPARSER_SCANNING_INLINE bool
+AbstractTokenizer::
+isTerm(string *str) const
+{
+    CharSpan span;
+
+    if (isTerm(span)) {
+        if (str != nullptr) span.assignTo(*str);
+        return true;
+    }
+
+    return false;
+}
+
+ABSTRACTPARSER_SCANNING_INLINE bool
+AbstractTokenizer::
+isTerm(CharSpan &term) const
+{
+    auto length = termCharLength(true);
+
+    if (!length)
+        return false;
+
+    const auto begin = getIterator();
+
+    do advance(length); while ((length = termCharLength(false)));
+
+    term = CharSpan(begin, getIterator());
+    return true;
+}
+
+ABSTRACTPARSER_SCANNING_INLINE void
+AbstractTokenizer::
+skipSpace() const noexcept
+{
+    while (isSpaceChar() && advance());
+
+    m_token_begin = inputOffset();
+}
+
+ABSTRACTPARSER_SCANNING_INLINE bool
+AbstractTokenizer::
+posStartsWith(const string &s, const bool case_insensitive) const
+{
+    ABSTRACTPARSER_PROFILE_COUNT(pos_starts_with_attempts, 1);
+
+    if (size_t(inputEnd() - getIterator()) >= s.length()) {
+        const auto result = case_insensitive ?
+            CaseFolding::equals(&*getIterator(), s.data(), s.length()) :
+            equal(s.begin(), s.end(), getIterator());
+
+        ABSTRACTPARSER_PROFILE_COUNT(pos_starts_with_hits, result);
+        return result;
+    }
+
+    return false;
+}
+
+ABSTRACTPARSER_SCANNING_INLINE bool
+AbstractTokenizer::
+posStartsWith(const DataContainer<string> &string_list, const bool case_insensitive) const
+{
+    for (const auto &s : string_list)
+        if (posStartsWith(s, case_insensitive))
+            return true;
+
+    return false;
+}
+
+ABSTRACTPARSER_SCANNING_INLINE bool
+AbstractTokenizer::
+isKeyword(const KeywordSet &keywords, CharSpan &keyword) const
+{
+    const auto length = keywords.match(&*getIterator(), &*inputEnd());
+
+    if (!length)
+        return false;
+
+    const auto end = getIterator(int64_t(length));
+
+    if (UnicodeIdentifier::asciiClass(*(end-1))) {
+        uint32_t code_point;
+        const bool term_continues = uint8_t(*end) < 0x80 ?
+            bool(UnicodeIdentifier::asciiClass(*end) & UnicodeIdentifier::ASCII_CONTINUE) :
+            UnicodeIdentifier::decodeUtf8(&*end, &*inputEnd(), code_point) &&
+            UnicodeIdentifier::isContinue(code_point);
+
+        if (term_continues)
+            return false;
+    }
+
+    const auto begin = getIterator();
+    advance(int64_t(length));
+
+    keyword = CharSpan(begin, getIterator());
+    return true;
+}
+
+ABSTRACTPARSER_SCANNING_INLINE bool
+AbstractTokenizer::
+isString(string &str) const
+{
+    CharSpan span;
+
+    if (isString(span)) {
+        span.assignTo(str);
+        return true;
+    }
+
+    return false;
+}
+
+ABSTRACTPARSER_SCANNING_INLINE bool
+AbstractTokenizer::
+isString(CharSpan &str) const
+{
+    if (currentChar({'"', '\''})) {
+        const auto begin = getIterator();
+
+        do advance(); while (!currentChar(*begin) && !isEndSentinel());
+
+        if (currentChar(*begin) && advance()) {
+            str = CharSpan(begin, getIterator());
+            return true;
+        }
+    }
+
+    return false;
+}
+
+ABSTRACTPARSER_SCANNING_INLINE bool
+AbstractTokenizer::
+isOneOfChars(const string::iterator iter, const string &allowed) const
+{
+    return find(allowed.begin(), allowed.end(), *iter) != allowed.end();
+}
+
+ABSTRACTPARSER_SCANNING_INLINE bool
+AbstractTokenizer::
+isCharOfRange(char from_char, char to_char) const
+{
+    return currentChar() >= from_char && currentChar() <= to_char;
+}
+
+ABSTRACTPARSER_SCANNING_INLINE string
+AbstractTokenizer::
+readCharSequence(const string &not_allowed_chars) const
+{
+    CharSpan span;
+    readCharSequence(not_allowed_chars, span);
+
+    return span.toString();
+}
+
+ABSTRACTPARSER_SCANNING_INLINE bool
+AbstractTokenizer::
+readCharSequence(const string &not_allowed_chars, CharSpan &char_sequence) const
+{
+    const auto begin = getIterator();
+
+    while (!isEndSentinel() && !isOneOfChars(not_allowed_chars) && advance());
+
+    char_sequence = CharSpan(begin, getIterator());
+    return !char_sequence.empty();
+}
+
+ABSTRACTPARSER_SCANNING_INLINE bool
+AbstractTokenizer::
+advanceSlowPath(int64_t count) const
+{
+    if ((count < 0 && getIterator(+count) < m_content->begin()) || getIterator(+count) > inputEnd()) return false;
+
+    if (count > 0) {
+        ABSTRACTPARSER_PROFILE_COUNT(bytes_advanced, count);
+        auto end = getIterator(+count);
+
+        while (getIterator() < end) {
+            const auto run = Scanning::plainAsciiRun(getIterator(), end);
+
+            if (run) {
+                m_iterator += run;
+                m_column += uint64_t(run);
+                continue;
+            }
+
+            // U+2028 and U+2029
+            if (m_line_endings & UNICODE_LS_PS && m_encoding == UTF8 &&
+                currentChar('\xe2') && nextChar('\x80') && (*getIterator(+2) == '\xa8' || *getIterator(+2) == '\xa9')) {
+                m_iterator += 3;
+                ++m_row; m_column = 1;
+                continue;
+            }
+
+            if (m_encoding == UTF8 && isUtf8MultibyteChar())
+                continue;
+
+            if (isTab() || isLineTerminator() || ++m_column)
+                ++m_iterator;
+        }
+    } else if (count < 0) {
+        if (getIterator()+count > m_content->begin()) m_iterator+=count;
+        else return false;
+    }
+
+    return true;
+}
+
+} // namespace Tokenization
+} // namespace Abstract
+
+#endif // ABSTRACTTOKENIZERSCANNING_H
@@ -0,0 +1,258 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "InputDecoder.h"
+#include <cstring>
+using namespace Abstract::Tokenization;
+
+namespace {
+
+const uint64_t HIGH_BITS         = 0x8080808080808080ULL;
+const uint64_t UTF16LE_NON_ASCII = 0xff80ff80ff80ff80ULL;
+const uint64_t UTF16BE_NON_ASCII = 0x80ff80ff80ff80ffULL;
+const uint32_t REPLACEMENT_CHAR  = 0xfffd;
+
+// Code points of the bytes 0x80-0x9f in Windows-1252. Undefined positions
+// are mapped to the C1 control with the same value.
+const uint16_t WINDOWS1252_C1[32] {
+    0x20ac, 0x0081, 0x201a, 0x0192, 0x201e, 0x2026, 0x2020, 0x2021,
+    0x02c6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008d, 0x017d, 0x008f,
+    0x0090, 0x2018, 0x2019, 0x201c, 0x201d, 0x2022, 0x2013, 0x2014,
+    0x02dc, 0x2122, 0x0161, 0x203a, 0x0153, 0x009d, 0x017e, 0x0178
+};
+
+inline uint64_t
+loadWord(const char *data)
+{
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+
+    return word;
+}
+
+// Length of the run of ASCII bytes starting at pos, in steps of 8 bytes
+inline size_t
+asciiRun(const string &input, size_t pos)
+{
+    const auto begin = pos;
+
+    while (input.size() - pos >= 8 && !(loadWord(input.data() + pos) & HIGH_BITS))
+        pos += 8;
+
+    return pos - begin;
+}
+
+inline bool
+startsWith(const string &input, const char *bom, const size_t length)
+{
+    return input.size() >= length && !memcmp(input.data(), bom, length);
+}
+
+void
+singleByteToUtf8(const string &input, const bool windows1252, string &output, size_t pos)
+{
+    output.reserve(output.size() + input.size() - pos + (input.size() - pos) / 8);
+
+    while (pos < input.size()) {
+        const auto run = asciiRun(input, pos);
+
+        if (run) {
+            output.append(input, pos, run);
+            pos += run;
+            continue;
+        }
+
+        const auto byte = uint8_t(input[pos++]);
+
+        if (byte < 0x80)
+            output += char(byte);
+        else if (windows1252 && byte < 0xa0)
+            InputDecoder::appendUtf8(output, WINDOWS1252_C1[byte - 0x80]);
+        else
+            InputDecoder::appendUtf8(output, byte);
+    }
+}
+
+void
+utf16ToUtf8(const string &input, const bool big_endian, string &output, size_t pos)
+{
+    const auto unit = [&input, big_endian](const size_t at) -> uint32_t {
+        return big_endian ?
+            uint32_t(uint8_t(input[at])) << 8 | uint8_t(input[at+1]) :
+            uint32_t(uint8_t(input[at+1])) << 8 | uint8_t(input[at]);
+    };
+
+    const auto non_ascii = big_endian ? UTF16BE_NON_ASCII : UTF16LE_NON_ASCII;
+
+    output.reserve(output.size() + (input.size() - pos) / 2);
+
+    while (input.size() - pos >= 2) {
+        // Four ASCII code units at once
+        if (input.size() - pos >= 8 && !(loadWord(input.data() + pos) & non_ascii)) {
+            for (size_t i = big_endian ? 1 : 0; i < 8; i += 2)
+                output += input[pos+i];
+
+            pos += 8;
+            continue;
+        }
+
+        auto code_point = unit(pos);
+        pos += 2;
+
+        if (code_point >= 0xd800 && code_point < 0xdc00) {
+            if (input.size() - pos >= 2 && unit(pos) >= 0xdc00 && unit(pos) < 0xe000) {
+                code_point = 0x10000 + ((code_point - 0xd800) << 10) + (unit(pos) - 0xdc00);
+                pos += 2;
+            }
+            else
+                code_point = REPLACEMENT_CHAR;
+        }
+        else if (code_point >= 0xdc00 && code_point < 0xe000)
+            code_point = REPLACEMENT_CHAR;
+
+        InputDecoder::appendUtf8(output, code_point);
+    }
+
+    if (pos < input.size())
+        InputDecoder::appendUtf8(output, REPLACEMENT_CHAR);
+}
+
+} // namespace
+
+auto
+InputDecoder::
+detectEncoding(const string &input, size_t &bom_length) -> Encoding
+{
+    bom_length = 0;
+
+    if (startsWith(input, "\xef\xbb\xbf", 3)) {
+        bom_length = 3;
+        return AbstractTokenizer::UTF8;
+    }
+
+    if (startsWith(input, "\xff\xfe", 2)) {
+        bom_length = 2;
+        return AbstractTokenizer::UTF16LE;
+    }
+
+    if (startsWith(input, "\xfe\xff", 2)) {
+        bom_length = 2;
+        return AbstractTokenizer::UTF16BE;
+    }
+
+    // UTF-16 without BOM: mostly ASCII text leaves every second byte zero
+    const auto sample = min(input.size() & ~size_t(1), size_t(256));
+    size_t even_zeros = 0, odd_zeros = 0;
+
+    for (size_t i = 0; i < sample; i += 2) {
+        even_zeros += !input[i];
+        odd_zeros  += !input[i+1];
+    }
+
+    if (sample && odd_zeros * 4 > sample && !even_zeros)
+        return AbstractTokenizer::UTF16LE;
+
+    if (sample && even_zeros * 4 > sample && !odd_zeros)
+        return AbstractTokenizer::UTF16BE;
+
+    if (isValidUtf8(input))
+        return AbstractTokenizer::UTF8;
+
+    for (const auto ch : input)
+        if (uint8_t(ch) >= 0x80 && uint8_t(ch) < 0xa0)
+            return AbstractTokenizer::WINDOWS125X;
+
+    return AbstractTokenizer::ISO8859;
+}
+
+bool
+InputDecoder::
+isValidUtf8(const string &input, size_t offset)
+{
+    auto pos = offset;
+
+    while (pos < input.size()) {
+        pos += asciiRun(input, pos);
+
+        if (pos == input.size())
+            break;
+
+        const auto byte = uint8_t(input[pos]);
+
+        if (byte < 0x80) {
+            ++pos;
+            continue;
+        }
+
+        size_t length;
+        uint32_t code_point, min_code_point;
+
+        if ((byte & 0xe0) == 0xc0)      { length = 2; code_point = byte & 0x1f; min_code_point = 0x80; }
+        else if ((byte & 0xf0) == 0xe0) { length = 3; code_point = byte & 0x0f; min_code_point = 0x800; }
+        else if ((byte & 0xf8) == 0xf0) { length = 4; code_point = byte & 0x07; min_code_point = 0x10000; }
+        else return false;
+
+        if (input.size() - pos < length)
+            return false;
+
+        for (size_t i = 1; i < length; ++i) {
+            const auto continuation = uint8_t(input[pos+i]);
+
+            if ((continuation & 0xc0) != 0x80)
+                return false;
+
+            code_point = code_point << 6 | (continuation & 0x3f);
+        }
+
+        if (code_point < min_code_point || code_point > 0x10ffff ||
+            (code_point >= 0xd800 && code_point < 0xe000))
+            return false;
+
+        pos += length;
+    }
+
+    return true;
+}
+
+bool
+InputDecoder::
+toUtf8(const string &input, const Encoding encoding, string &output, size_t offset)
+{
+    switch (encoding) {
+    case AbstractTokenizer::UTF8:
+        if (!isValidUtf8(input, offset)) return false;
+        output.append(input, offset, string::npos);
+        return true;
+
+    case AbstractTokenizer::ISO8859:
+    case AbstractTokenizer::WINDOWS125X:
+        singleByteToUtf8(input, encoding == AbstractTokenizer::WINDOWS125X, output, offset);
+        return true;
+
+    case AbstractTokenizer::UTF16LE:
+    case AbstractTokenizer::UTF16BE:
+        utf16ToUtf8(input, encoding == AbstractTokenizer::UTF16BE, output, offset);
+        return true;
+
+    default:
+        return false;
+    }
+}
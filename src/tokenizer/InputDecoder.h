@@ -0,0 +1,85 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef INPUTDECODER_H
+#define INPUTDECODER_H
+#include "AbstractTokenizer.h"
+
+namespace Abstract {
+namespace Tokenization {
+
+// Detects the encoding of raw input and transcodes it to UTF-8, so the
+// tokenizer only ever has to handle a single encoding. ASCII runs are
+// processed eight bytes at a time.
+class InputDecoder
+{
+public:
+    using Encoding = AbstractTokenizer::Encoding;
+
+    InputDecoder() = delete;
+
+    // Sniffs a byte order mark first. Without one, input with NUL bytes in
+    // every second position is reported as UTF-16, valid UTF-8 as UTF8 and
+    // anything else as WINDOWS125X or ISO8859 depending on whether bytes
+    // from the 0x80-0x9f range occur.
+    static Encoding
+    detectEncoding          (const string &input, size_t &bom_length);
+
+    static bool
+    isValidUtf8             (const string &input, size_t offset = 0);
+
+    // Appends the UTF-8 representation of input[offset..] to output.
+    // Invalid UTF-16 sequences are replaced by U+FFFD.
+    static bool
+    toUtf8                  (const string &input, const Encoding encoding,
+                             string &output, size_t offset = 0);
+
+    static inline void
+    appendUtf8              (string &output, const uint32_t code_point);
+};
+
+inline void
+InputDecoder::
+appendUtf8(string &output, const uint32_t code_point)
+{
+    if (code_point < 0x80)
+        output += char(code_point);
+    else if (code_point < 0x800) {
+        output += char(0xc0 | (code_point >> 6));
+        output += char(0x80 | (code_point & 0x3f));
+    }
+    else if (code_point < 0x10000) {
+        output += char(0xe0 | (code_point >> 12));
+        output += char(0x80 | ((code_point >> 6) & 0x3f));
+        output += char(0x80 | (code_point & 0x3f));
+    }
+    else {
+        output += char(0xf0 | (code_point >> 18));
+        output += char(0x80 | ((code_point >> 12) & 0x3f));
+        output += char(0x80 | ((code_point >> 6) & 0x3f));
+        output += char(0x80 | (code_point & 0x3f));
+    }
+}
+
+} // namespace Tokenization
+} // namespace Abstract
+
+#endif // INPUTDECODER_H
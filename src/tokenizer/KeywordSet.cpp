@@ -0,0 +1,156 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "KeywordSet.h"
+#include <algorithm>
+using namespace Abstract::Tokenization;
+
+#define FOLD_ROW(b) \
+    uint8_t(b+0), uint8_t(b+1), uint8_t(b+2),  uint8_t(b+3),  uint8_t(b+4),  uint8_t(b+5),  uint8_t(b+6),  uint8_t(b+7), \
+    uint8_t(b+8), uint8_t(b+9), uint8_t(b+10), uint8_t(b+11), uint8_t(b+12), uint8_t(b+13), uint8_t(b+14), uint8_t(b+15)
+
+#define FOLD_UPPER_ROW(b) \
+    uint8_t((b+0)  >= 'A' && (b+0)  <= 'Z' ? (b+0)  + 0x20 : (b+0)),  \
+    uint8_t((b+1)  >= 'A' && (b+1)  <= 'Z' ? (b+1)  + 0x20 : (b+1)),  \
+    uint8_t((b+2)  >= 'A' && (b+2)  <= 'Z' ? (b+2)  + 0x20 : (b+2)),  \
+    uint8_t((b+3)  >= 'A' && (b+3)  <= 'Z' ? (b+3)  + 0x20 : (b+3)),  \
+    uint8_t((b+4)  >= 'A' && (b+4)  <= 'Z' ? (b+4)  + 0x20 : (b+4)),  \
+    uint8_t((b+5)  >= 'A' && (b+5)  <= 'Z' ? (b+5)  + 0x20 : (b+5)),  \
+    uint8_t((b+6)  >= 'A' && (b+6)  <= 'Z' ? (b+6)  + 0x20 : (b+6)),  \
+    uint8_t((b+7)  >= 'A' && (b+7)  <= 'Z' ? (b+7)  + 0x20 : (b+7)),  \
+    uint8_t((b+8)  >= 'A' && (b+8)  <= 'Z' ? (b+8)  + 0x20 : (b+8)),  \
+    uint8_t((b+9)  >= 'A' && (b+9)  <= 'Z' ? (b+9)  + 0x20 : (b+9)),  \
+    uint8_t((b+10) >= 'A' && (b+10) <= 'Z' ? (b+10) + 0x20 : (b+10)), \
+    uint8_t((b+11) >= 'A' && (b+11) <= 'Z' ? (b+11) + 0x20 : (b+11)), \
+    uint8_t((b+12) >= 'A' && (b+12) <= 'Z' ? (b+12) + 0x20 : (b+12)), \
+    uint8_t((b+13) >= 'A' && (b+13) <= 'Z' ? (b+13) + 0x20 : (b+13)), \
+    uint8_t((b+14) >= 'A' && (b+14) <= 'Z' ? (b+14) + 0x20 : (b+14)), \
+    uint8_t((b+15) >= 'A' && (b+15) <= 'Z' ? (b+15) + 0x20 : (b+15))
+
+const uint8_t CaseFolding::FOLD[256] = {
+    FOLD_ROW(0x00), FOLD_ROW(0x10), FOLD_ROW(0x20), FOLD_ROW(0x30),
+    FOLD_UPPER_ROW(0x40), FOLD_UPPER_ROW(0x50), FOLD_ROW(0x60), FOLD_ROW(0x70),
+    FOLD_ROW(0x80), FOLD_ROW(0x90), FOLD_ROW(0xa0), FOLD_ROW(0xb0),
+    FOLD_ROW(0xc0), FOLD_ROW(0xd0), FOLD_ROW(0xe0), FOLD_ROW(0xf0)
+};
+
+#undef FOLD_UPPER_ROW
+#undef FOLD_ROW
+
+KeywordSet::KeywordSet(const bool case_insensitive) :
+    m_case_insensitive(case_insensitive) {}
+
+KeywordSet &
+KeywordSet::
+add(const string &keyword)
+{
+    if (keyword.empty() || contains(keyword))
+        return *this;
+
+    string stored = keyword;
+
+    if (m_case_insensitive)
+        transform(stored.begin(), stored.end(), stored.begin(), CaseFolding::fold);
+
+    const auto index = uint32_t(m_keywords.size());
+    m_keywords.push_back(move(stored));
+
+    // Longest keywords first, so the first hit of a prefix match is the longest
+    auto &candidates = m_by_first_byte[uint8_t(m_keywords.back().front())];
+    const auto position = find_if(candidates.begin(), candidates.end(), [this, index](const uint32_t other) {
+        return m_keywords[other].length() < m_keywords[index].length();
+    });
+    candidates.insert(position, index);
+
+    if (m_keywords.size() * 2 > m_buckets.size())
+        rehash();
+    else {
+        auto bucket = hash(m_keywords.back().data(), m_keywords.back().length()) & (m_buckets.size() - 1);
+
+        while (m_buckets[bucket] >= 0)
+            bucket = (bucket + 1) & (m_buckets.size() - 1);
+
+        m_buckets[bucket] = int32_t(index);
+    }
+
+    return *this;
+}
+
+size_t
+KeywordSet::
+match(const char *begin, const char *end) const
+{
+    if (begin >= end)
+        return 0;
+
+    const auto first = uint8_t(m_case_insensitive ? CaseFolding::fold(*begin) : *begin);
+    const auto available = size_t(end - begin);
+
+    for (const auto index : m_by_first_byte[first]) {
+        const auto &keyword = m_keywords[index];
+
+        if (keyword.length() <= available && equals(begin, keyword))
+            return keyword.length();
+    }
+
+    return 0;
+}
+
+bool
+KeywordSet::
+contains(const char *begin, const size_t length) const
+{
+    if (m_buckets.empty())
+        return false;
+
+    auto bucket = hash(begin, length) & (m_buckets.size() - 1);
+
+    // Linear probing, the table is at most half full
+    for (; m_buckets[bucket] >= 0; bucket = (bucket + 1) & (m_buckets.size() - 1)) {
+        const auto &keyword = m_keywords[size_t(m_buckets[bucket])];
+
+        if (keyword.length() == length && equals(begin, keyword))
+            return true;
+    }
+
+    return false;
+}
+
+void
+KeywordSet::
+rehash()
+{
+    size_t bucket_count = 16;
+
+    while (bucket_count < m_keywords.size() * 4)
+        bucket_count *= 2;
+
+    m_buckets.assign(bucket_count, -1);
+
+    for (size_t i = 0; i < m_keywords.size(); ++i) {
+        auto bucket = hash(m_keywords[i].data(), m_keywords[i].length()) & (bucket_count - 1);
+
+        while (m_buckets[bucket] >= 0)
+            bucket = (bucket + 1) & (bucket_count - 1);
+
+        m_buckets[bucket] = int32_t(i);
+    }
+}
@@ -0,0 +1,258 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef KEYWORDSET_H
+#define KEYWORDSET_H
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Abstract {
+namespace Tokenization {
+using namespace std;
+
+// ASCII case folding without calls to tolower(): single bytes go through a
+// lookup table, 8 byte words are folded branchlessly by OR-ing 0x20 into
+// the bytes 'A'..'Z'. Bytes outside ASCII are left unchanged.
+class CaseFolding
+{
+public:
+    CaseFolding() = delete;
+
+    static inline char
+    fold                    (const char ch);
+
+    static inline uint64_t
+    foldWord                (const uint64_t word);
+
+    // Compares length bytes ignoring ASCII case
+    static inline bool
+    equals                  (const char *a, const char *b, const size_t length),
+
+    // Same, with the second operand already folded
+    equalsFolded            (const char *input, const char *folded, const size_t length);
+
+    // FNV-1a over the folded bytes
+    static inline uint64_t
+    hash                    (const char *data, const size_t length);
+
+private:
+    static const uint8_t FOLD[256];
+
+    template<bool FoldSecond>
+    static inline bool
+    compare                 (const char *a, const char *b, size_t length);
+};
+
+// Function objects for unordered containers keyed case-insensitively
+struct CaseInsensitiveHash
+{
+    inline size_t
+    operator()              (const string &str) const;
+};
+
+struct CaseInsensitiveEqual
+{
+    inline bool
+    operator()              (const string &a, const string &b) const;
+};
+
+// Set of keywords which is folded once at registration. Input is folded on
+// the fly while being compared, so case-insensitive matching costs about
+// the same as case-sensitive matching. Candidates for a prefix match are
+// bucketed by their first byte and tried longest first; whole words are
+// looked up in a hash table over the folded bytes.
+class KeywordSet
+{
+public:
+    explicit
+    KeywordSet(const bool case_insensitive = true);
+
+    KeywordSet &
+    add                     (const string &keyword);
+
+    // Length of the longest keyword [begin, end) starts with, 0 if none
+    size_t
+    match                   (const char *begin, const char *end) const;
+
+    bool
+    contains                (const char *begin, const size_t length) const;
+
+    inline bool
+    contains                (const string &word) const,
+
+    caseInsensitive         () const;
+
+    inline size_t
+    size                    () const;
+
+private:
+    inline bool
+    equals                  (const char *input, const string &keyword) const;
+
+    inline uint64_t
+    hash                    (const char *data, const size_t length) const;
+
+    void
+    rehash                  ();
+
+    bool m_case_insensitive;
+    vector<string> m_keywords;
+    vector<uint32_t> m_by_first_byte[256];
+    vector<int32_t> m_buckets;
+};
+
+inline char
+CaseFolding::
+fold(const char ch)
+{
+    return char(FOLD[uint8_t(ch)]);
+}
+
+inline uint64_t
+CaseFolding::
+foldWord(const uint64_t word)
+{
+    const uint64_t ones = 0x0101010101010101ULL, high_bits = 0x8080808080808080ULL;
+    const auto low = word & ~high_bits;
+
+    // High bit of each byte set for 'A' <= byte <= 'Z', bytes >= 0x80 excluded
+    const auto at_least_a = low + ones * (0x80 - 'A');
+    const auto above_z    = low + ones * (0x80 - 'Z' - 1);
+    const auto upper      = at_least_a & ~above_z & ~word & high_bits;
+
+    return word | (upper >> 2);
+}
+
+template<bool FoldSecond>
+inline bool
+CaseFolding::
+compare(const char *a, const char *b, size_t length)
+{
+    for (; length >= 8; a += 8, b += 8, length -= 8) {
+        uint64_t word_a, word_b;
+        memcpy(&word_a, a, sizeof(word_a));
+        memcpy(&word_b, b, sizeof(word_b));
+
+        if (foldWord(word_a) != (FoldSecond ? foldWord(word_b) : word_b))
+            return false;
+    }
+
+    for (; length; ++a, ++b, --length)
+        if (fold(*a) != (FoldSecond ? fold(*b) : *b))
+            return false;
+
+    return true;
+}
+
+inline bool
+CaseFolding::
+equals(const char *a, const char *b, const size_t length)
+{
+    return compare<true>(a, b, length);
+}
+
+inline bool
+CaseFolding::
+equalsFolded(const char *input, const char *folded, const size_t length)
+{
+    return compare<false>(input, folded, length);
+}
+
+inline uint64_t
+CaseFolding::
+hash(const char *data, const size_t length)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= FOLD[uint8_t(data[i])];
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+inline size_t
+CaseInsensitiveHash::
+operator()(const string &str) const
+{
+    return size_t(CaseFolding::hash(str.data(), str.length()));
+}
+
+inline bool
+CaseInsensitiveEqual::
+operator()(const string &a, const string &b) const
+{
+    return a.length() == b.length() && CaseFolding::equals(a.data(), b.data(), a.length());
+}
+
+inline bool
+KeywordSet::
+contains(const string &word) const
+{
+    return contains(word.data(), word.length());
+}
+
+inline bool
+KeywordSet::
+caseInsensitive() const
+{
+    return m_case_insensitive;
+}
+
+inline size_t
+KeywordSet::
+size() const
+{
+    return m_keywords.size();
+}
+
+inline bool
+KeywordSet::
+equals(const char *input, const string &keyword) const
+{
+    return m_case_insensitive ? CaseFolding::equalsFolded(input, keyword.data(), keyword.length())
+                              : memcmp(input, keyword.data(), keyword.length()) == 0;
+}
+
+inline uint64_t
+KeywordSet::
+hash(const char *data, const size_t length) const
+{
+    if (m_case_insensitive)
+        return CaseFolding::hash(data, length);
+
+    uint64_t hash = 0xcbf29ce484222325ULL;
+
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= uint8_t(data[i]);
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+} // namespace Tokenization
+} // namespace Abstract
+
+#endif // KEYWORDSET_H
@@ -0,0 +1,541 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "Lexer.h"
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <map>
+#include <vector>
+using namespace Abstract::Tokenization;
+
+namespace {
+
+using ByteSet = bitset<256>;
+
+struct NfaState
+{
+    ByteSet          bytes;
+    int32_t          byte_target {-1};
+    vector<int32_t>  epsilon;
+    int32_t          accepting_rule {-1};
+};
+
+struct Fragment
+{
+    int32_t begin, end;
+};
+
+// Recursive descent parser which builds a Thompson NFA from a pattern
+class PatternCompiler
+{
+public:
+    PatternCompiler(vector<NfaState> &states, const string &pattern) :
+        m_states(states), m_pattern(pattern) {}
+
+    bool
+    compile(Fragment &fragment)
+    {
+        fragment = alternation();
+
+        if (m_error.empty() && m_pos != m_pattern.length())
+            m_error = "Unexpected ')'";
+
+        return m_error.empty();
+    }
+
+    const string &
+    error() const
+    {
+        return m_error;
+    }
+
+private:
+    int32_t
+    newState()
+    {
+        m_states.emplace_back();
+        return int32_t(m_states.size() - 1);
+    }
+
+    Fragment
+    byteFragment(const ByteSet &bytes)
+    {
+        const Fragment fragment {newState(), newState()};
+        m_states[size_t(fragment.begin)].bytes = bytes;
+        m_states[size_t(fragment.begin)].byte_target = fragment.end;
+
+        return fragment;
+    }
+
+    Fragment
+    alternation()
+    {
+        auto fragment = sequence();
+
+        while (m_error.empty() && m_pos < m_pattern.length() && m_pattern[m_pos] == '|') {
+            ++m_pos;
+
+            const auto right = sequence();
+            const Fragment joined {newState(), newState()};
+
+            m_states[size_t(joined.begin)].epsilon = {fragment.begin, right.begin};
+            m_states[size_t(fragment.end)].epsilon.emplace_back(joined.end);
+            m_states[size_t(right.end)].epsilon.emplace_back(joined.end);
+
+            fragment = joined;
+        }
+
+        return fragment;
+    }
+
+    Fragment
+    sequence()
+    {
+        const auto begin = newState();
+        Fragment fragment {begin, begin};
+
+        while (m_error.empty() && m_pos < m_pattern.length() &&
+               m_pattern[m_pos] != '|' && m_pattern[m_pos] != ')') {
+            const auto next = quantified();
+            m_states[size_t(fragment.end)].epsilon.emplace_back(next.begin);
+            fragment.end = next.end;
+        }
+
+        return fragment;
+    }
+
+    Fragment
+    quantified()
+    {
+        auto fragment = atom();
+
+        while (m_error.empty() && m_pos < m_pattern.length() &&
+               (m_pattern[m_pos] == '*' || m_pattern[m_pos] == '+' || m_pattern[m_pos] == '?')) {
+            const auto quantifier = m_pattern[m_pos++];
+            const Fragment wrapped {newState(), newState()};
+
+            m_states[size_t(wrapped.begin)].epsilon.emplace_back(fragment.begin);
+            m_states[size_t(fragment.end)].epsilon.emplace_back(wrapped.end);
+
+            if (quantifier != '+')
+                m_states[size_t(wrapped.begin)].epsilon.emplace_back(wrapped.end);
+
+            if (quantifier != '?')
+                m_states[size_t(fragment.end)].epsilon.emplace_back(fragment.begin);
+
+            fragment = wrapped;
+        }
+
+        return fragment;
+    }
+
+    Fragment
+    atom()
+    {
+        const auto ch = m_pattern[m_pos++];
+        ByteSet bytes;
+
+        switch (ch) {
+        case '(': {
+            const auto fragment = alternation();
+
+            if (m_pos >= m_pattern.length() || m_pattern[m_pos] != ')')
+                m_error = "Missing ')'";
+            else
+                ++m_pos;
+
+            return fragment;
+        }
+
+        case '[':
+            characterClass(bytes);
+            break;
+
+        case '.':
+            bytes.set();
+            bytes.reset('\n');
+            break;
+
+        case '\\':
+            escape(bytes);
+            break;
+
+        case '*': case '+': case '?':
+            m_error = string("Quantifier '") + ch + "' without operand";
+            break;
+
+        default:
+            bytes.set(uint8_t(ch));
+        }
+
+        return byteFragment(bytes);
+    }
+
+    void
+    escape(ByteSet &bytes)
+    {
+        if (m_pos >= m_pattern.length()) {
+            m_error = "Pattern ends with '\\'";
+            return;
+        }
+
+        const auto ch = m_pattern[m_pos++];
+
+        switch (ch) {
+        case 'n': bytes.set('\n'); break;
+        case 'r': bytes.set('\r'); break;
+        case 't': bytes.set('\t'); break;
+        case 'd': for (auto c = '0'; c <= '9'; ++c) bytes.set(uint8_t(c)); break;
+        case 's': for (const auto c : string(" \t\n\r\f\v")) bytes.set(uint8_t(c)); break;
+        case 'w':
+            for (uint16_t c = 0; c < 128; ++c)
+                if (isalnum(c) || c == '_') bytes.set(c);
+            break;
+        default:  bytes.set(uint8_t(ch));
+        }
+    }
+
+    void
+    characterClass(ByteSet &bytes)
+    {
+        const auto negated = m_pos < m_pattern.length() && m_pattern[m_pos] == '^';
+        if (negated) ++m_pos;
+
+        bool first = true;
+
+        while (m_pos < m_pattern.length() && (first || m_pattern[m_pos] != ']')) {
+            first = false;
+
+            ByteSet single;
+            auto from = m_pattern[m_pos++];
+
+            if (from == '\\') {
+                escape(single);
+
+                if (single.count() != 1) {
+                    bytes |= single;
+                    continue;
+                }
+
+                for (uint16_t c = 0; c < 256; ++c)
+                    if (single[c]) from = char(c);
+            }
+
+            if (m_pos + 1 < m_pattern.length() && m_pattern[m_pos] == '-' && m_pattern[m_pos+1] != ']') {
+                ++m_pos;
+                ByteSet upper;
+                auto to = m_pattern[m_pos++];
+
+                if (to == '\\') {
+                    escape(upper);
+
+                    for (uint16_t c = 0; c < 256; ++c)
+                        if (upper[c]) to = char(c);
+                }
+
+                for (auto c = uint16_t(uint8_t(from)); c <= uint8_t(to); ++c)
+                    bytes.set(c);
+            }
+            else
+                bytes.set(uint8_t(from));
+        }
+
+        if (m_pos >= m_pattern.length())
+            m_error = "Missing ']'";
+        else
+            ++m_pos;
+
+        if (negated)
+            bytes.flip();
+    }
+
+    vector<NfaState> &m_states;
+    const string &m_pattern;
+    size_t m_pos {0};
+    string m_error;
+};
+
+void
+epsilonClosure(const vector<NfaState> &states, vector<int32_t> &set)
+{
+    vector<bool> contained(states.size(), false);
+    vector<int32_t> pending(set);
+
+    for (const auto state : set)
+        contained[size_t(state)] = true;
+
+    while (!pending.empty()) {
+        const auto state = pending.back();
+        pending.pop_back();
+
+        for (const auto target : states[size_t(state)].epsilon) {
+            if (!contained[size_t(target)]) {
+                contained[size_t(target)] = true;
+                set.emplace_back(target);
+                pending.emplace_back(target);
+            }
+        }
+    }
+
+    sort(set.begin(), set.end());
+}
+
+} // namespace
+
+LexerSpecification &
+LexerSpecification::
+addRule(const string &pattern, const uint16_t kind, const int32_t priority, TokenFactory factory)
+{
+    m_rules.emplace_back(Rule {pattern, kind, priority, false, move(factory)});
+    return *this;
+}
+
+LexerSpecification &
+LexerSpecification::
+addSkipRule(const string &pattern, const int32_t priority)
+{
+    m_rules.emplace_back(Rule {pattern, 0, priority, true, nullptr});
+    return *this;
+}
+
+string
+LexerSpecification::
+literal(const string &str)
+{
+    string escaped;
+    escaped.reserve(str.length() * 2);
+
+    for (const auto ch : str) {
+        if (string("\\.[]()|*+?^").find(ch) != string::npos)
+            escaped += '\\';
+
+        escaped += ch;
+    }
+
+    return escaped;
+}
+
+Lexer::Lexer(LexerSpecification specification) :
+    m_specification(move(specification))
+{
+    compile();
+}
+
+void
+Lexer::
+compile()
+{
+    // Pattern -> NFA
+    vector<NfaState> nfa;
+    const auto nfa_start = int32_t(0);
+    nfa.emplace_back();
+
+    const auto &rules = m_specification.rules();
+
+    for (size_t i = 0; i < rules.size(); ++i) {
+        Fragment fragment;
+        PatternCompiler compiler(nfa, rules[i].pattern);
+
+        if (!compiler.compile(fragment)) {
+            m_error_message = "Invalid pattern '" + rules[i].pattern + "': " + compiler.error();
+            return;
+        }
+
+        nfa[size_t(nfa_start)].epsilon.emplace_back(fragment.begin);
+        nfa[size_t(fragment.end)].accepting_rule = int32_t(i);
+    }
+
+    // Bytes which no pattern distinguishes share one input class
+    memset(m_byte_classes, 0, sizeof(m_byte_classes));
+    m_class_count = 1;
+
+    for (const auto &state : nfa) {
+        if (state.byte_target < 0) continue;
+
+        map<pair<uint8_t, bool>, uint8_t> refined;
+
+        for (uint16_t c = 0; c < 256; ++c) {
+            const auto key = make_pair(m_byte_classes[c], bool(state.bytes[c]));
+            const auto result = refined.emplace(key, uint8_t(refined.size()));
+            m_byte_classes[c] = result.first->second;
+        }
+
+        m_class_count = uint16_t(refined.size());
+    }
+
+    vector<uint8_t> class_representatives(m_class_count);
+
+    for (uint16_t c = 0; c < 256; ++c)
+        class_representatives[m_byte_classes[c]] = uint8_t(c);
+
+    // NFA -> DFA by subset construction, state 0 is the empty (dead) set
+    map<vector<int32_t>, uint32_t> dfa_states;
+    vector<vector<int32_t>> subsets(1);
+    vector<uint32_t> transitions;
+    dfa_states[vector<int32_t>()] = 0;
+
+    vector<int32_t> start_set {nfa_start};
+    epsilonClosure(nfa, start_set);
+    dfa_states[start_set] = 1;
+    subsets.emplace_back(start_set);
+
+    for (size_t state = 0; state < subsets.size(); ++state) {
+        for (uint16_t cls = 0; cls < m_class_count; ++cls) {
+            vector<int32_t> target;
+
+            for (const auto nfa_state : subsets[state]) {
+                const auto &s = nfa[size_t(nfa_state)];
+
+                if (s.byte_target >= 0 && s.bytes[class_representatives[cls]])
+                    target.emplace_back(s.byte_target);
+            }
+
+            epsilonClosure(nfa, target);
+
+            const auto result = dfa_states.emplace(target, uint32_t(subsets.size()));
+
+            if (result.second)
+                subsets.emplace_back(target);
+
+            transitions.emplace_back(result.first->second);
+        }
+    }
+
+    vector<int32_t> accepting(subsets.size(), -1);
+
+    for (size_t state = 0; state < subsets.size(); ++state) {
+        for (const auto nfa_state : subsets[state]) {
+            const auto rule = nfa[size_t(nfa_state)].accepting_rule;
+
+            if (rule >= 0 && (accepting[state] < 0 ||
+                rules[size_t(rule)].priority > rules[size_t(accepting[state])].priority ||
+                (rules[size_t(rule)].priority == rules[size_t(accepting[state])].priority &&
+                 rule < accepting[state])))
+                accepting[state] = rule;
+        }
+    }
+
+    // Minimization by partition refinement, starting with one group per
+    // accepted rule. The dead state keeps group 0.
+    vector<uint32_t> groups(subsets.size());
+    size_t group_count = 0;
+
+    for (bool changed = true; changed;) {
+        map<vector<int64_t>, uint32_t> signatures;
+        vector<uint32_t> refined(subsets.size());
+
+        for (size_t state = 0; state < subsets.size(); ++state) {
+            vector<int64_t> signature {group_count ? int64_t(groups[state]) : int64_t(accepting[state])};
+
+            if (group_count)
+                for (uint16_t cls = 0; cls < m_class_count; ++cls)
+                    signature.emplace_back(groups[transitions[state * m_class_count + cls]]);
+
+            refined[state] = signatures.emplace(signature, uint32_t(signatures.size())).first->second;
+        }
+
+        changed = signatures.size() != group_count;
+        group_count = signatures.size();
+        groups = refined;
+    }
+
+    // Renumber so the dead state's group becomes state 0
+    vector<int64_t> numbering(group_count, -1);
+    numbering[groups[0]] = 0;
+    uint32_t next_number = 1;
+
+    for (size_t state = 1; state < subsets.size(); ++state)
+        if (numbering[groups[state]] < 0)
+            numbering[groups[state]] = next_number++;
+
+    m_transitions.assign(group_count * m_class_count, 0);
+    m_accepting_rules.assign(group_count, -1);
+
+    for (size_t state = 0; state < subsets.size(); ++state) {
+        const auto number = size_t(numbering[groups[state]]);
+        m_accepting_rules[number] = accepting[state];
+
+        for (uint16_t cls = 0; cls < m_class_count; ++cls)
+            m_transitions[number * m_class_count + cls] =
+                uint32_t(numbering[groups[transitions[state * m_class_count + cls]]]);
+    }
+
+    m_start_state = uint32_t(numbering[groups[1]]);
+}
+
+size_t
+Lexer::
+match(const char *begin, const char *end, int32_t &rule, bool &at_end,
+      LexerMemo &memo, const uint64_t offset, const bool input_complete) const
+{
+    // Recorded dead ends all lie behind begin once it passed the last one
+    if (memo.m_lexer != this || offset >= memo.m_end_offset) {
+        memo.m_failed.clear();
+        memo.m_lexer = this;
+    }
+
+    const uint64_t state_count = stateCount();
+    size_t length = 0;
+    auto state = m_start_state;
+    auto pos = begin;
+    bool known_dead_end = false;
+
+    rule = -1;
+    memo.m_trail.clear();
+
+    for (; pos != end; ++pos) {
+        state = m_transitions[state * m_class_count + m_byte_classes[uint8_t(*pos)]];
+
+        if (!state)
+            break;
+
+        if (!memo.m_failed.empty() &&
+            memo.m_failed.count((offset + uint64_t(pos - begin) + 1) * state_count + state)) {
+            known_dead_end = true;
+            break;
+        }
+
+        if (m_accepting_rules[state] >= 0) {
+            rule = m_accepting_rules[state];
+            length = size_t(pos - begin) + 1;
+            memo.m_trail.clear();
+        }
+        else
+            memo.m_trail.push_back(state);
+    }
+
+    at_end = state != 0 && !known_dead_end;
+
+    // The states behind the match lead into a dead end, unless more input
+    // may follow
+    if (!at_end || input_complete) {
+        auto trail_offset = offset + length + 1;
+
+        for (const auto trail_state : memo.m_trail)
+            memo.m_failed.insert(trail_offset++ * state_count + trail_state);
+
+        memo.m_end_offset = max(memo.m_end_offset, trail_offset);
+    }
+
+    return length;
+}
+
@@ -0,0 +1,227 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef LEXER_H
+#define LEXER_H
+#include "AbstractTokenizer.h"
+#include <functional>
+#include <unordered_set>
+#include <vector>
+
+namespace Abstract {
+namespace Tokenization {
+
+// Declarative token rules which are compiled by Lexer into a minimized DFA.
+//
+// Patterns are byte oriented regular expressions supporting literals,
+// escapes (\n \r \t \d \w \s and escaped meta characters), '.' (any byte
+// except newline), character classes ([a-z_], [^"\n]), groups, alternation
+// and the quantifiers '*', '+' and '?'. When several rules match the same
+// longest input, the rule with the highest priority wins, then the rule
+// which was added first.
+class LexerSpecification
+{
+public:
+    // Creates the token for a match, the default creates an AbstractToken
+    using TokenFactory = function<AbstractTokenPtr(const CharSpan &match)>;
+
+    struct Rule
+    {
+        string       pattern;
+        uint16_t     kind;
+        int32_t      priority;
+        bool         skip;
+        TokenFactory factory;
+    };
+
+    LexerSpecification &
+    addRule                 (const string &pattern, const uint16_t kind,
+                             const int32_t priority = 0,
+                             TokenFactory factory = nullptr);
+
+    // Matches are consumed without emitting a token, e.g. whitespace
+    LexerSpecification &
+    addSkipRule             (const string &pattern, const int32_t priority = 0);
+
+    inline const DataContainer<Rule> &
+    rules                   () const;
+
+    // Escapes all meta characters of str
+    static string
+    literal                 (const string &str);
+
+private:
+    DataContainer<Rule> m_rules;
+};
+
+class Lexer;
+
+// (state, offset) pairs from which earlier scans of the same input died
+// without reaching another accepting state. Consulting them lets repeated
+// longest matches over one input run in linear time, instead of rescanning
+// the same dead ends for every token (Reps, "Maximal-munch tokenization in
+// linear time").
+class LexerMemo
+{
+public:
+    inline void
+    clear                   ();
+
+private:
+    friend class Lexer;
+
+    const Lexer *m_lexer {nullptr};
+    uint64_t m_end_offset {0};
+    unordered_set<uint64_t> m_failed;
+    vector<uint32_t> m_trail;
+};
+
+class Lexer
+{
+public:
+    explicit
+    Lexer(LexerSpecification specification);
+
+    inline bool
+    isValid                 () const;
+
+    inline const string &
+    errorMessage            () const;
+
+    inline const LexerSpecification &
+    specification           () const;
+
+    // Longest match at begin. Returns the matched length in bytes and sets
+    // rule to the index of the matching rule, -1 if nothing matches.
+    // at_end is set if the input ended while a longer match was possible.
+    inline size_t
+    match                   (const char *begin, const char *end, int32_t &rule) const,
+    match                   (const char *begin, const char *end, int32_t &rule, bool &at_end) const;
+
+    // Same, for consecutive matches over one input: offset is the position
+    // of begin in the input. Dead ends met here are recorded in memo, and
+    // later matches stop as soon as they reach one. Scans which run out of
+    // input only count as dead ends if end is the end of the whole input.
+    size_t
+    match                   (const char *begin, const char *end, int32_t &rule, bool &at_end,
+                             LexerMemo &memo, const uint64_t offset, const bool input_complete) const;
+
+    inline size_t
+    stateCount              () const;
+
+private:
+    void
+    compile                 ();
+
+    LexerSpecification m_specification;
+
+    uint8_t  m_byte_classes[256];
+    uint16_t m_class_count {1};
+    uint32_t m_start_state {0};
+
+    // Dense transition table, state 0 is the dead state
+    vector<uint32_t> m_transitions;
+    vector<int32_t>  m_accepting_rules;
+
+    string m_error_message;
+};
+
+inline void
+LexerMemo::
+clear()
+{
+    m_lexer = nullptr;
+    m_end_offset = 0;
+    m_failed.clear();
+}
+
+inline const DataContainer<LexerSpecification::Rule> &
+LexerSpecification::
+rules() const
+{
+    return m_rules;
+}
+
+inline bool
+Lexer::
+isValid() const
+{
+    return m_error_message.empty();
+}
+
+inline const string &
+Lexer::
+errorMessage() const
+{
+    return m_error_message;
+}
+
+inline const LexerSpecification &
+Lexer::
+specification() const
+{
+    return m_specification;
+}
+
+inline size_t
+Lexer::
+match(const char *begin, const char *end, int32_t &rule) const
+{
+    bool at_end;
+    return match(begin, end, rule, at_end);
+}
+
+inline size_t
+Lexer::
+match(const char *begin, const char *end, int32_t &rule, bool &at_end) const
+{
+    size_t length = 0;
+    auto state = m_start_state;
+
+    rule = -1;
+
+    for (auto pos = begin; pos != end; ++pos) {
+        state = m_transitions[state * m_class_count + m_byte_classes[uint8_t(*pos)]];
+
+        if (!state)
+            break;
+
+        if (m_accepting_rules[state] >= 0) {
+            rule = m_accepting_rules[state];
+            length = size_t(pos - begin) + 1;
+        }
+    }
+
+    at_end = state != 0;
+    return length;
+}
+
+inline size_t
+Lexer::
+stateCount() const
+{
+    return m_accepting_rules.size();
+}
+
+} // namespace Tokenization
+} // namespace Abstract
+
+#endif // LEXER_H
@@ -0,0 +1,115 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "LineIndex.h"
+#include <cstring>
+using namespace Abstract::Tokenization;
+
+LineIndex::LineIndex(const string::iterator begin, const string::iterator end, const uint8_t line_endings) :
+    m_begin(begin)
+{
+    const char *data = &*begin;
+    const auto length = size_t(end - begin);
+
+    const auto add_line = [this](const size_t terminator, const size_t next_line) {
+        m_line_ends.emplace_back(terminator);
+        m_line_begins.emplace_back(next_line);
+    };
+
+    m_line_begins.emplace_back(0);
+
+    // Without CR and Unicode separators every line ends at a '\n', so only
+    // these need to be inspected
+    if (!(line_endings & (AbstractTokenizer::CR | AbstractTokenizer::UNICODE_LS_PS))) {
+        for (const char *pos = data; pos < data + length;) {
+            const auto found = static_cast<const char *>(memchr(pos, '\n', size_t(data + length - pos)));
+
+            if (!found)
+                break;
+
+            const auto terminator = size_t(found - data);
+            pos = found + 1;
+
+            if (line_endings & AbstractTokenizer::CRLF && terminator && data[terminator-1] == '\r')
+                add_line(terminator - 1, terminator + 1);
+            else if (line_endings & AbstractTokenizer::LF)
+                add_line(terminator, terminator + 1);
+        }
+    }
+    else {
+        for (size_t pos = 0; pos < length; ++pos) {
+            const auto ch = data[pos];
+
+            if (ch == '\n') {
+                if (line_endings & AbstractTokenizer::LF)
+                    add_line(pos, pos + 1);
+            }
+            else if (ch == '\r') {
+                if (line_endings & AbstractTokenizer::CRLF && pos + 1 < length && data[pos+1] == '\n') {
+                    add_line(pos, pos + 2);
+                    ++pos;
+                }
+                else if (line_endings & AbstractTokenizer::CR)
+                    add_line(pos, pos + 1);
+            }
+            else if (ch == '\xe2' && line_endings & AbstractTokenizer::UNICODE_LS_PS &&
+                     pos + 2 < length && data[pos+1] == '\x80' &&
+                     (data[pos+2] == '\xa8' || data[pos+2] == '\xa9')) {
+                add_line(pos, pos + 3);
+                pos += 2;
+            }
+        }
+    }
+
+    m_line_ends.emplace_back(length);
+}
+
+size_t
+LineIndex::
+offsetAt(const size_t line, const uint64_t column, const uint8_t tab_width) const
+{
+    const char *data = &*m_begin;
+    const auto end = m_line_ends[line];
+    auto pos = m_line_begins[line];
+
+    for (uint64_t current = 1; pos < end; ) {
+        const auto lead = uint8_t(data[pos]);
+        const uint64_t width = lead == '\t' ? tab_width : 1;
+        size_t length = 1;
+
+        if (lead >= 0xf0)      length = 4;
+        else if (lead >= 0xe0) length = 3;
+        else if (lead >= 0xc0) length = 2;
+
+        // Invalid sequences count one column per byte, as in advance()
+        for (size_t i = 1; i < length; ++i)
+            if (pos + i >= end || (uint8_t(data[pos+i]) & 0xc0) != 0x80)
+                length = 1;
+
+        if (column < current + width)
+            return pos;
+
+        current += width;
+        pos += length;
+    }
+
+    return end;
+}
@@ -0,0 +1,105 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+#include "AbstractTokenizer.h"
+#include <vector>
+
+namespace Abstract {
+namespace Tokenization {
+
+// Start offsets of all lines of an input, built in one pass according to a
+// line ending policy (see AbstractTokenizer::LineEnding). Lines can be read
+// as spans without their terminators, which gives a normalized view of the
+// input without copying it.
+class LineIndex
+{
+public:
+    LineIndex(const string::iterator begin, const string::iterator end,
+              const uint8_t line_endings = AbstractTokenizer::LF | AbstractTokenizer::CRLF);
+
+    inline size_t
+    lineCount               () const,
+
+    // 0-based line containing the byte at offset
+    lineOf                  (const size_t offset) const,
+
+    lineBegin               (const size_t line) const,
+
+    // Offset of the line terminator, or of the end of input for the last line
+    lineEnd                 (const size_t line) const;
+
+    // Line content without its terminator
+    inline CharSpan
+    line                    (const size_t line) const;
+
+    // Offset of the character at the 1-based column of a line, counting
+    // columns like AbstractTokenizer::advance (tabs advance by tab_width,
+    // UTF-8 characters by one). Columns behind the line map to its end.
+    size_t
+    offsetAt                (const size_t line, const uint64_t column,
+                             const uint8_t tab_width = 4) const;
+
+private:
+    string::iterator m_begin;
+    vector<size_t> m_line_begins, m_line_ends;
+};
+
+inline size_t
+LineIndex::
+lineCount() const
+{
+    return m_line_begins.size();
+}
+
+inline size_t
+LineIndex::
+lineOf(const size_t offset) const
+{
+    return size_t(upper_bound(m_line_begins.begin(), m_line_begins.end(), offset) - m_line_begins.begin()) - 1;
+}
+
+inline size_t
+LineIndex::
+lineBegin(const size_t line) const
+{
+    return m_line_begins[line];
+}
+
+inline size_t
+LineIndex::
+lineEnd(const size_t line) const
+{
+    return m_line_ends[line];
+}
+
+inline CharSpan
+LineIndex::
+line(const size_t line) const
+{
+    return CharSpan(m_begin + int64_t(m_line_begins[line]), m_begin + int64_t(m_line_ends[line]));
+}
+
+} // namespace Tokenization
+} // namespace Abstract
+
+#endif // LINEINDEX_H
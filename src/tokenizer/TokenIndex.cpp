@@ -0,0 +1,74 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "TokenIndex.h"
+#include <algorithm>
+using namespace Abstract::Tokenization;
+
+TokenIndex::TokenIndex(const AbstractTokenStream &tokens)
+{
+    m_entries.reserve(tokens.size());
+
+    for (const auto &token : tokens)
+        m_entries.push_back({token->offset(), token->offset() + token->sourceLength()});
+}
+
+size_t
+TokenIndex::
+tokenAt(const uint64_t offset) const
+{
+    // Last token starting at or before offset
+    const auto it = upper_bound(m_entries.begin(), m_entries.end(), offset,
+                                [](const uint64_t o, const Entry &entry) {
+                                    return o < entry.begin;
+                                });
+
+    if (it == m_entries.begin() || offset >= (it-1)->end)
+        return NO_TOKEN;
+
+    return size_t(it - m_entries.begin()) - 1;
+}
+
+size_t
+TokenIndex::
+tokenAt(const uint64_t row, const uint64_t column, const LineIndex &lines, const uint8_t tab_width) const
+{
+    if (!row || row > lines.lineCount())
+        return NO_TOKEN;
+
+    return tokenAt(lines.offsetAt(size_t(row - 1), column, tab_width));
+}
+
+pair<size_t, size_t>
+TokenIndex::
+tokensInRange(const uint64_t begin, const uint64_t end) const
+{
+    const auto first = upper_bound(m_entries.begin(), m_entries.end(), begin,
+                                   [](const uint64_t o, const Entry &entry) {
+                                       return o < entry.end;
+                                   });
+    const auto last = lower_bound(first, m_entries.end(), end,
+                                  [](const Entry &entry, const uint64_t o) {
+                                      return entry.begin < o;
+                                  });
+
+    return make_pair(size_t(first - m_entries.begin()), size_t(last - m_entries.begin()));
+}
@@ -0,0 +1,82 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef TOKENINDEX_H
+#define TOKENINDEX_H
+#include "AbstractTokenizer.h"
+#include "LineIndex.h"
+#include <utility>
+#include <vector>
+
+namespace Abstract {
+namespace Tokenization {
+
+// Offset ordered index of a token stream, answering position queries by
+// binary search. It only relies on the offsets and source lengths stored in
+// the tokens, so it works as well on streams loaded from a TokenStreamCache.
+// The stream has to be in input order, as produced by appendToken().
+//
+// A token covers the bytes [offset, offset + source length) of the input.
+class TokenIndex
+{
+public:
+    enum : size_t { NO_TOKEN = size_t(-1) };
+
+    explicit
+    TokenIndex(const AbstractTokenStream &tokens);
+
+    // Index of the token covering the byte at offset, or NO_TOKEN
+    size_t
+    tokenAt                 (const uint64_t offset) const,
+
+    // Index of the token covering the given 1-based position, or NO_TOKEN.
+    // The position is converted to an offset through the line index of the
+    // input, see LineIndex::offsetAt.
+    tokenAt                 (const uint64_t row, const uint64_t column,
+                             const LineIndex &lines, const uint8_t tab_width = 4) const;
+
+    // Indexes [first, last) of the tokens overlapping the bytes [begin, end)
+    pair<size_t, size_t>
+    tokensInRange           (const uint64_t begin, const uint64_t end) const;
+
+    inline size_t
+    size                    () const;
+
+private:
+    struct Entry
+    {
+        uint64_t begin, end;
+    };
+
+    vector<Entry> m_entries;
+};
+
+inline size_t
+TokenIndex::
+size() const
+{
+    return m_entries.size();
+}
+
+} // namespace Tokenization
+} // namespace Abstract
+
+#endif // TOKENINDEX_H
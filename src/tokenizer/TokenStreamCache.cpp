@@ -0,0 +1,393 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "TokenStreamCache.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+using namespace Abstract::Tokenization;
+
+namespace {
+
+const char     FORMAT_MAGIC[4] {'A', 'P', 'L', 'T'};
+const uint8_t  FORMAT_VERSION = 3;
+const size_t   DIGEST_SIZE = 32;
+const char    *CACHE_FILE_EXTENSION = ".apltok";
+
+inline void
+writeVarint(string &out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out += char((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+
+    out += char(value);
+}
+
+inline bool
+readVarint(const string &in, size_t &pos, uint64_t &value)
+{
+    value = 0;
+
+    for (uint8_t shift = 0; pos < in.size() && shift < 64; shift += 7) {
+        const auto byte = uint8_t(in[pos++]);
+        value |= uint64_t(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80))
+            return true;
+    }
+
+    return false;
+}
+
+inline uint64_t
+zigzagEncode(const int64_t value)
+{
+    return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+}
+
+inline int64_t
+zigzagDecode(const uint64_t value)
+{
+    return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+// SHA-256 (FIPS 180-4), so a cache entry can't be taken for the entry of
+// other content, as it could with a 64 bit hash
+class Sha256
+{
+public:
+    void
+    update(const string &bytes)
+    {
+        for (const auto ch : bytes) {
+            m_block[m_block_size++] = uint8_t(ch);
+
+            if (m_block_size == sizeof(m_block)) {
+                compress();
+                m_block_size = 0;
+            }
+        }
+
+        m_length += bytes.length();
+    }
+
+    string
+    digest()
+    {
+        const auto bit_length = m_length * 8;
+        string padding(1, char(0x80));
+
+        padding.append((119 - m_length % 64) % 64, '\0');
+
+        for (int shift = 56; shift >= 0; shift -= 8)
+            padding += char(bit_length >> shift);
+
+        update(padding);
+
+        string result;
+
+        for (const auto word : m_state)
+            for (int shift = 24; shift >= 0; shift -= 8)
+                result += char(word >> shift);
+
+        return result;
+    }
+
+private:
+    static inline uint32_t
+    rotateRight(const uint32_t value, const uint8_t count)
+    {
+        return (value >> count) | (value << (32 - count));
+    }
+
+    void
+    compress()
+    {
+        static const uint32_t ROUND_CONSTANTS[64] {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+        };
+
+        uint32_t w[64];
+
+        for (uint8_t i = 0; i < 16; ++i)
+            w[i] = uint32_t(m_block[i*4]) << 24 | uint32_t(m_block[i*4+1]) << 16 |
+                   uint32_t(m_block[i*4+2]) << 8 | uint32_t(m_block[i*4+3]);
+
+        for (uint8_t i = 16; i < 64; ++i)
+            w[i] = w[i-16] + (rotateRight(w[i-15], 7) ^ rotateRight(w[i-15], 18) ^ (w[i-15] >> 3)) +
+                   w[i-7]  + (rotateRight(w[i-2], 17) ^ rotateRight(w[i-2], 19)  ^ (w[i-2] >> 10));
+
+        auto a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3],
+             e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+
+        for (uint8_t i = 0; i < 64; ++i) {
+            const auto t1 = h + (rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25)) +
+                            ((e & f) ^ (~e & g)) + ROUND_CONSTANTS[i] + w[i];
+            const auto t2 = (rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22)) +
+                            ((a & b) ^ (a & c) ^ (b & c));
+
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        m_state[0] += a; m_state[1] += b; m_state[2] += c; m_state[3] += d;
+        m_state[4] += e; m_state[5] += f; m_state[6] += g; m_state[7] += h;
+    }
+
+    uint32_t m_state[8] {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    uint8_t  m_block[64];
+    size_t   m_block_size {0};
+    uint64_t m_length {0};
+};
+
+} // namespace
+
+TokenStreamCache::TokenStreamCache(const string &directory, const string &tokenizer_id) :
+    m_directory(directory), m_tokenizer_id(tokenizer_id) {}
+
+bool
+TokenStreamCache::
+store(const string &content, const AbstractTokenStreamPtr &token_stream) const
+{
+    const auto digest = contentDigest(content, m_tokenizer_id);
+    const auto path = cacheFilePath(digest);
+
+    // Unique per process, thread and call, as parallel builds may store the
+    // same entry at the same time
+    static atomic<uint64_t> store_count {0};
+    const auto unique_id = uint64_t(chrono::steady_clock::now().time_since_epoch().count())
+                         ^ uint64_t(std::hash<thread::id>()(this_thread::get_id()))
+                         ^ uint64_t(reinterpret_cast<uintptr_t>(&store_count));
+    const auto temp_path = path + "." + to_string(unique_id) + "." + to_string(store_count++) + ".tmp";
+
+    {
+        ofstream file(temp_path, ios::binary | ios::trunc);
+
+        if (!file)
+            return false;
+
+        const auto data = serialize(token_stream, digest);
+        file.write(data.data(), streamsize(data.size()));
+
+        if (!file) {
+            file.close();
+            remove(temp_path.c_str());
+            return false;
+        }
+    }
+
+    remove(path.c_str());
+
+    if (rename(temp_path.c_str(), path.c_str()) != 0) {
+        remove(temp_path.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+AbstractTokenStreamPtr
+TokenStreamCache::
+load(const string &content, const TokenFactory &factory) const
+{
+    const auto digest = contentDigest(content, m_tokenizer_id);
+    ifstream file(cacheFilePath(digest), ios::binary | ios::ate);
+
+    if (!file)
+        return nullptr;
+
+    string data(size_t(file.tellg()), '\0');
+    file.seekg(0);
+
+    if (!file.read(&data[0], streamsize(data.size())))
+        return nullptr;
+
+    return deserialize(data, factory, digest);
+}
+
+string
+TokenStreamCache::
+serialize(const AbstractTokenStreamPtr &token_stream, const string &content_digest)
+{
+    unordered_map<string, uint64_t> string_indices;
+    DataContainer<const string *> strings;
+    string token_data;
+
+    token_data.reserve(token_stream->size() * 4);
+    writeVarint(token_data, token_stream->size());
+
+    uint64_t prev_row = 0, prev_offset = 0;
+
+    for (const auto &token : *token_stream) {
+        uint64_t string_index = 0;
+
+        if (token->contentPtr()) {
+            const auto result = string_indices.emplace(token->content(), strings.size() + 1);
+
+            if (result.second)
+                strings.emplace_back(&result.first->first);
+
+            string_index = result.first->second;
+        }
+
+        writeVarint(token_data, token->kind());
+        writeVarint(token_data, string_index);
+        writeVarint(token_data, zigzagEncode(int64_t(token->row() - prev_row)));
+        writeVarint(token_data, token->column());
+        writeVarint(token_data, zigzagEncode(int64_t(token->offset() - prev_offset)));
+        writeVarint(token_data, token->sourceLength());
+
+        prev_row = token->row();
+        prev_offset = token->offset();
+    }
+
+    string data(FORMAT_MAGIC, sizeof(FORMAT_MAGIC));
+    data += char(FORMAT_VERSION);
+    data += content_digest.length() == DIGEST_SIZE ? content_digest : string(DIGEST_SIZE, '\0');
+    writeVarint(data, strings.size());
+
+    for (const auto &str : strings) {
+        writeVarint(data, str->length());
+        data += *str;
+    }
+
+    data += token_data;
+    return data;
+}
+
+AbstractTokenStreamPtr
+TokenStreamCache::
+deserialize(const string &data, const TokenFactory &factory, const string &content_digest)
+{
+    size_t pos = sizeof(FORMAT_MAGIC) + 1 + DIGEST_SIZE;
+    uint64_t length, count;
+
+    if (data.size() < pos ||
+        !equal(begin(FORMAT_MAGIC), end(FORMAT_MAGIC), data.begin()) ||
+        uint8_t(data[sizeof(FORMAT_MAGIC)]) != FORMAT_VERSION ||
+        (!content_digest.empty() && data.compare(sizeof(FORMAT_MAGIC) + 1, DIGEST_SIZE, content_digest) != 0) ||
+        !readVarint(data, pos, count) || count > data.size())
+        return nullptr;
+
+    DataContainer<shared_ptr<string>> strings;
+    strings.reserve(size_t(count));
+
+    while (count--) {
+        if (!readVarint(data, pos, length) || data.size() - pos < length)
+            return nullptr;
+
+        strings.emplace_back(make_shared<string>(data, pos, size_t(length)));
+        pos += size_t(length);
+    }
+
+    if (!readVarint(data, pos, count) || count > data.size())
+        return nullptr;
+
+    const auto token_stream = make_shared<AbstractTokenStream>();
+    token_stream->reserve(size_t(count));
+
+    uint64_t row = 0, offset = 0, kind, string_index, row_delta, column, offset_delta, source_length;
+
+    while (count--) {
+        if (!readVarint(data, pos, kind) || !readVarint(data, pos, string_index) ||
+            !readVarint(data, pos, row_delta) || !readVarint(data, pos, column) ||
+            !readVarint(data, pos, offset_delta) || !readVarint(data, pos, source_length) ||
+            string_index > strings.size())
+            return nullptr;
+
+        const auto token = factory(uint16_t(kind));
+
+        if (!token)
+            return nullptr;
+
+        row += uint64_t(zigzagDecode(row_delta));
+        offset += uint64_t(zigzagDecode(offset_delta));
+
+        if (string_index)
+            token->setContentPtr(strings[size_t(string_index-1)]);
+
+        token->setKind(uint16_t(kind));
+        token->setRow(row);
+        token->setColumn(column);
+        token->setOffset(offset);
+        token->setSourceLength(source_length);
+        token_stream->emplace_back(token);
+    }
+
+    return token_stream;
+}
+
+string
+TokenStreamCache::
+contentDigest(const string &content, const string &tokenizer_id)
+{
+    string prefix;
+    Sha256 sha256;
+
+    // The length keeps the tokenizer id apart from the content
+    writeVarint(prefix, tokenizer_id.length());
+    prefix += tokenizer_id;
+    prefix += char(FORMAT_VERSION);
+
+    sha256.update(prefix);
+    sha256.update(content);
+
+    return sha256.digest();
+}
+
+string
+TokenStreamCache::
+cacheFilePath(const string &content_digest) const
+{
+    stringstream path;
+
+    path << m_directory;
+
+    if (!m_directory.empty() && m_directory.back() != '/' && m_directory.back() != '\\')
+        path << '/';
+
+    path << hex;
+    path.fill('0');
+
+    for (const auto ch : content_digest) {
+        path.width(2);
+        path << unsigned(uint8_t(ch));
+    }
+
+    path << CACHE_FILE_EXTENSION;
+
+    return path.str();
+}
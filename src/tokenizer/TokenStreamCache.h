@@ -0,0 +1,81 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef TOKENSTREAMCACHE_H
+#define TOKENSTREAMCACHE_H
+#include "AbstractTokenizer.h"
+#include <functional>
+
+namespace Abstract {
+namespace Tokenization {
+
+// Serializes token streams into a compact, versioned binary format and keeps
+// them in an on-disk cache directory keyed by the SHA-256 digest of the
+// tokenized content, so unchanged input does not have to be tokenized again.
+// Loading compares the digest stored in the entry with the one of the
+// content, so an entry is never returned for other content.
+//
+// Format (all integers are LEB128 varints unless noted):
+//   magic "APLT" (4 bytes), format version (1 byte),
+//   content digest (32 bytes, all zero if none),
+//   string count, { length, bytes }...,
+//   token count,  { kind, string index + 1 (0 = no content),
+//                   zigzag row delta, column, zigzag offset delta,
+//                   source length }...
+class TokenStreamCache
+{
+public:
+    using TokenFactory = function<AbstractTokenPtr(const uint16_t kind)>;
+
+    explicit
+    TokenStreamCache(const string &directory, const string &tokenizer_id = "");
+
+    bool
+    store(const string &content, const AbstractTokenStreamPtr &token_stream) const;
+
+    AbstractTokenStreamPtr
+    load(const string &content, const TokenFactory &factory) const;
+
+    static string
+    serialize(const AbstractTokenStreamPtr &token_stream,
+              const string &content_digest = "");
+
+    // Fails if a content digest is given and differs from the stored one
+    static AbstractTokenStreamPtr
+    deserialize(const string &data,
+                const TokenFactory &factory,
+                const string &content_digest = "");
+
+    // SHA-256 over the tokenizer id, the format version and the content
+    static string
+    contentDigest(const string &content, const string &tokenizer_id = "");
+
+private:
+    string
+    cacheFilePath(const string &content_digest) const;
+
+    string m_directory, m_tokenizer_id;
+};
+
+} // namespace Tokenization
+} // namespace Abstract
+
+#endif // TOKENSTREAMCACHE_H
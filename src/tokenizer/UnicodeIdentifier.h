@@ -0,0 +1,131 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef UNICODEIDENTIFIER_H
+#define UNICODEIDENTIFIER_H
+#include <cstdint>
+
+namespace Abstract {
+namespace Tokenization {
+
+// Classification of identifier characters. ASCII is answered by a single
+// table lookup, other code points by the XID_Start/XID_Continue two-stage
+// tables in UnicodeIdentifierTables.cpp, which are generated by
+// tools/generate_unicode_tables.py.
+class UnicodeIdentifier
+{
+public:
+    enum AsciiClass : uint8_t { ASCII_START = 1, ASCII_CONTINUE = 2 };
+
+    UnicodeIdentifier() = delete;
+
+    static inline bool
+    isStart                 (const uint32_t code_point),
+    isContinue              (const uint32_t code_point);
+
+    // Identifier class of an ASCII byte as used by AbstractTokenizer::isTerm:
+    // letters start a term, letters, digits, '-' and '_' continue it
+    static inline uint8_t
+    asciiClass              (const char ch);
+
+    // Decodes one UTF-8 character of [begin, end) and returns its length in
+    // bytes, or 0 for an invalid or truncated sequence. Overlong encodings,
+    // surrogates and code points above U+10FFFF are invalid.
+    static inline uint8_t
+    decodeUtf8              (const char *begin, const char *end, uint32_t &code_point);
+
+private:
+    static const uint8_t  ASCII_CLASSES[128];
+    static const uint8_t  STAGE1[0x110000 >> 8];
+    static const uint64_t STAGE2[][8];
+
+    static inline bool
+    lookup                  (const uint32_t code_point, const uint8_t offset);
+};
+
+inline bool
+UnicodeIdentifier::
+lookup(const uint32_t code_point, const uint8_t offset)
+{
+    if (code_point > 0x10ffff)
+        return false;
+
+    return (STAGE2[STAGE1[code_point >> 8]][offset + ((code_point & 0xff) >> 6)] >> (code_point & 0x3f)) & 1;
+}
+
+inline bool
+UnicodeIdentifier::
+isStart(const uint32_t code_point)
+{
+    return code_point < 0x80 ? bool(ASCII_CLASSES[code_point] & ASCII_START) : lookup(code_point, 0);
+}
+
+inline bool
+UnicodeIdentifier::
+isContinue(const uint32_t code_point)
+{
+    return code_point < 0x80 ? bool(ASCII_CLASSES[code_point] & ASCII_CONTINUE) && code_point != '-' : lookup(code_point, 4);
+}
+
+inline uint8_t
+UnicodeIdentifier::
+asciiClass(const char ch)
+{
+    return ASCII_CLASSES[uint8_t(ch) & 0x7f] & -uint8_t(uint8_t(ch) < 0x80);
+}
+
+inline uint8_t
+UnicodeIdentifier::
+decodeUtf8(const char *begin, const char *end, uint32_t &code_point)
+{
+    const auto byte = uint8_t(*begin);
+    uint8_t length;
+
+    if (byte < 0x80)                { code_point = byte;        return 1; }
+    else if ((byte & 0xe0) == 0xc0) { code_point = byte & 0x1f; length = 2; }
+    else if ((byte & 0xf0) == 0xe0) { code_point = byte & 0x0f; length = 3; }
+    else if ((byte & 0xf8) == 0xf0) { code_point = byte & 0x07; length = 4; }
+    else return 0;
+
+    if (end - begin < length)
+        return 0;
+
+    for (uint8_t i = 1; i < length; ++i) {
+        if ((uint8_t(begin[i]) & 0xc0) != 0x80)
+            return 0;
+
+        code_point = code_point << 6 | (uint8_t(begin[i]) & 0x3f);
+    }
+
+    // Smallest code point which needs the given number of bytes
+    static const uint32_t MIN_CODE_POINTS[5] {0, 0, 0x80, 0x800, 0x10000};
+
+    if (code_point < MIN_CODE_POINTS[length] || (code_point >= 0xd800 && code_point <= 0xdfff) ||
+        code_point > 0x10ffff)
+        return 0;
+
+    return length;
+}
+
+} // namespace Tokenization
+} // namespace Abstract
+
+#endif // UNICODEIDENTIFIER_H
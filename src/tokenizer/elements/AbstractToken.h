@@ -28,13 +28,23 @@ along with this program. If not, see <https://www.gnu.org/licenses/>.
 #undef EOF
 #endif
 
+// With ABSTRACTPARSER_FINAL_TOKENS tokens carry no vtable and cannot be
+// derived from; token types are then distinguished by kind() only
+#ifdef ABSTRACTPARSER_FINAL_TOKENS
+#  define ABSTRACTTOKEN_FINAL final
+#  define ABSTRACTTOKEN_VIRTUAL
+#else
+#  define ABSTRACTTOKEN_FINAL
+#  define ABSTRACTTOKEN_VIRTUAL virtual
+#endif
+
 namespace Abstract {
 namespace Tokenization {
 namespace Tokens {
 
 using namespace std;
 
-class AbstractToken
+class AbstractToken ABSTRACTTOKEN_FINAL
 {
 public:
     AbstractToken(AbstractToken &) = delete;
@@ -54,13 +64,17 @@ public:
     AbstractToken(const char c),
     AbstractToken(const string &content);
 
-    virtual
+    ABSTRACTTOKEN_VIRTUAL
     ~AbstractToken() = default;
 
     inline void
 	setContent(const string &content),
+    setContentPtr(shared_ptr<string> content),
     setRow(const uint64_t row),
-    setColumn(const uint64_t column);
+    setColumn(const uint64_t column),
+    setOffset(const uint64_t offset),
+    setSourceLength(const uint64_t length),
+    setKind(const uint16_t kind);
 
     inline const string &
     content() const;
@@ -75,10 +89,21 @@ public:
     hasContent(const initializer_list<string> content_list) const;
 
     inline uint64_t
-    row() const, column() const;
+    row() const, column() const,
+
+    // Byte offset of the token in the (normalized) input
+    offset() const,
+
+    // Length in bytes of the source text of the token, which may differ from
+    // its content, e.g. for strings stored without quotes
+    sourceLength() const;
+
+    inline uint16_t
+    kind() const;
 
 private:
-    uint64_t m_row {1}, m_column {1};
+    uint64_t m_row {1}, m_column {1}, m_offset {0}, m_source_length {0};
+    uint16_t m_kind {0};
 	shared_ptr<string> m_content;
 };
 
@@ -94,11 +119,24 @@ inline void
 AbstractToken::
 setContent(const string &content)
 {
-    !m_content && (m_content = make_shared<string>());
+    // The content may be shared with other tokens, e.g. interned strings of
+    // a TokenStreamCache, so it is only overwritten in place if unshared
+    if (!m_content || m_content.use_count() > 1) {
+        m_content = make_shared<string>(content);
+        return;
+    }
+
 	m_content->reserve(content.length());
 	*m_content = content;
 }
 
+inline void
+AbstractToken::
+setContentPtr(shared_ptr<string> content)
+{
+    m_content = move(content);
+}
+
 inline const string &
 AbstractToken::
 content() const
@@ -177,6 +215,48 @@ column() const
     return m_column;
 }
 
+inline void
+AbstractToken::
+setOffset(const uint64_t offset)
+{
+    m_offset = offset;
+}
+
+inline uint64_t
+AbstractToken::
+offset() const
+{
+    return m_offset;
+}
+
+inline void
+AbstractToken::
+setSourceLength(const uint64_t length)
+{
+    m_source_length = length;
+}
+
+inline uint64_t
+AbstractToken::
+sourceLength() const
+{
+    return m_source_length;
+}
+
+inline void
+AbstractToken::
+setKind(const uint16_t kind)
+{
+    m_kind = kind;
+}
+
+inline uint16_t
+AbstractToken::
+kind() const
+{
+    return m_kind;
+}
+
 using AbstractTokenPtr = shared_ptr<AbstractToken>;
 
 } // namespace Tokens
@@ -0,0 +1,210 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "ByteWiseTokenizer.h"
+#include "../tokenizer/UnicodeIdentifier.h"
+using namespace Abstract::Verification;
+
+ByteWiseTokenizer::ByteWiseTokenizer(const string &input, const uint8_t line_endings, const uint8_t tab_width) :
+    m_input(input), m_line_endings(line_endings), m_tab_width(tab_width),
+    m_tokens(make_shared<AbstractTokenStream>()) {}
+
+bool
+ByteWiseTokenizer::
+run()
+{
+    while (m_pos < m_input.length()) {
+        const auto ch = byte(m_pos);
+
+        if (ch == ' ' || (ch >= '\t' && ch <= '\r')) {
+            advance();
+            continue;
+        }
+
+        const auto begin = m_pos;
+        const auto row = m_row, column = m_column;
+
+        if (startsWith("/*")) {
+            advance(); advance();
+            const auto content_begin = m_pos;
+
+            while (m_pos < m_input.length() && !startsWith("*/"))
+                advance();
+
+            if (!startsWith("*/"))
+                return false;
+
+            const auto content_end = m_pos;
+            advance(); advance();
+
+            appendToken(ReferenceTokenizer::COMMENT, begin, row, column,
+                        m_input.substr(content_begin, content_end - content_begin));
+            continue;
+        }
+
+        if (ch == '"' || ch == '\'') {
+            do advance(); while (m_pos < m_input.length() && byte(m_pos) != ch);
+
+            if (m_pos >= m_input.length())
+                return false;
+
+            advance();
+            appendToken(ReferenceTokenizer::STRING, begin, row, column, m_input.substr(begin, m_pos - begin));
+            continue;
+        }
+
+        if (termCharLength(true)) {
+            do advance(); while (termCharLength(false));
+
+            appendToken(ReferenceTokenizer::TERM, begin, row, column, m_input.substr(begin, m_pos - begin));
+            continue;
+        }
+
+        advance();
+        appendToken(ReferenceTokenizer::CHARACTER, begin, row, column, m_input.substr(begin, m_pos - begin));
+    }
+
+    return true;
+}
+
+uint8_t
+ByteWiseTokenizer::
+byte(const size_t pos) const
+{
+    // Behind the input reads like the NUL padding of AbstractTokenizer
+    return pos < m_input.length() ? uint8_t(m_input[pos]) : 0;
+}
+
+uint8_t
+ByteWiseTokenizer::
+utf8Length(const size_t pos) const
+{
+    const auto lead = byte(pos);
+    uint8_t length;
+
+    if (lead >= 0xf0)      length = 4;
+    else if (lead >= 0xe0) length = 3;
+    else if (lead >= 0xc0) length = 2;
+    else return 0;
+
+    for (uint8_t i = 1; i < length; ++i)
+        if ((byte(pos + i) & 0xc0) != 0x80)
+            return 0;
+
+    return length;
+}
+
+uint8_t
+ByteWiseTokenizer::
+termCharLength(const bool is_start) const
+{
+    const auto ch = byte(m_pos);
+
+    if (ch < 0x80) {
+        const bool letter = (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+        const bool digit = ch >= '0' && ch <= '9';
+
+        return letter || (!is_start && (digit || ch == '_' || ch == '-'));
+    }
+
+    uint32_t code_point;
+    const auto length = UnicodeIdentifier::decodeUtf8(&m_input[m_pos], m_input.data() + m_input.length(), code_point);
+
+    return length && (is_start ? UnicodeIdentifier::isStart(code_point) :
+                                 UnicodeIdentifier::isContinue(code_point)) ? length : 0;
+}
+
+bool
+ByteWiseTokenizer::
+startsWith(const char *s) const
+{
+    for (size_t i = 0; s[i]; ++i)
+        if (m_pos + i >= m_input.length() || m_input[m_pos + i] != s[i])
+            return false;
+
+    return true;
+}
+
+void
+ByteWiseTokenizer::
+advance()
+{
+    const auto ch = byte(m_pos);
+
+    if (m_line_endings & AbstractTokenizer::UNICODE_LS_PS &&
+        ch == 0xe2 && byte(m_pos + 1) == 0x80 && (byte(m_pos + 2) == 0xa8 || byte(m_pos + 2) == 0xa9)) {
+        m_pos += 3;
+        ++m_row; m_column = 1;
+        return;
+    }
+
+    if (const auto length = utf8Length(m_pos)) {
+        m_pos += length;
+        ++m_column;
+        return;
+    }
+
+    switch (ch) {
+    case '\t':
+        m_column += m_tab_width;
+        break;
+
+    case '\n':
+        if (m_line_endings & AbstractTokenizer::LF ||
+            (m_line_endings & AbstractTokenizer::CRLF && m_pos && byte(m_pos - 1) == '\r')) {
+            ++m_row; m_column = 1;
+        }
+        else
+            ++m_column;
+        break;
+
+    case '\r':
+        // The row of a CRLF pair changes at its '\n'
+        if (m_line_endings & AbstractTokenizer::CRLF && byte(m_pos + 1) == '\n')
+            break;
+
+        if (m_line_endings & AbstractTokenizer::CR) {
+            ++m_row; m_column = 1;
+        }
+        else
+            ++m_column;
+        break;
+
+    default:
+        ++m_column;
+    }
+
+    ++m_pos;
+}
+
+void
+ByteWiseTokenizer::
+appendToken(const uint16_t kind, const size_t begin, const uint64_t row, const uint64_t column, const string &content)
+{
+    const auto token = make_shared<AbstractToken>(content);
+
+    token->setKind(kind);
+    token->setRow(row);
+    token->setColumn(column);
+    token->setOffset(begin);
+    token->setSourceLength(m_pos - begin);
+    m_tokens->emplace_back(token);
+}
@@ -0,0 +1,86 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef BYTEWISETOKENIZER_H
+#define BYTEWISETOKENIZER_H
+#include "ReferenceTokenizer.h"
+
+namespace Abstract {
+namespace Verification {
+using namespace Abstract::Tokenization;
+
+// Independent oracle for ReferenceTokenizer which does not use any scanning
+// code of AbstractTokenizer. It walks the input one byte at a time with a
+// frozen copy of the position rules of AbstractTokenizer::advance (UTF-8
+// characters, tabs, line ending policies) and produces the same tokens as
+// ReferenceTokenizer, so optimizations of the shared scanning helpers are
+// checked against code they can't change.
+//
+// Keep this implementation simple rather than fast; it is only meant to be
+// obviously correct.
+class ByteWiseTokenizer
+{
+public:
+    explicit
+    ByteWiseTokenizer(const string &input,
+                      const uint8_t line_endings = AbstractTokenizer::LF | AbstractTokenizer::CRLF,
+                      const uint8_t tab_width = 4);
+
+    // Returns false on an unterminated comment or string
+    bool
+    run                     ();
+
+    inline const AbstractTokenStreamPtr &
+    tokens                  () const;
+
+private:
+    uint8_t
+    byte                    (const size_t pos) const,
+    utf8Length              (const size_t pos) const,
+    termCharLength          (const bool is_start) const;
+
+    bool
+    startsWith              (const char *s) const;
+
+    void
+    advance                 (),
+    appendToken             (const uint16_t kind, const size_t begin, const uint64_t row,
+                             const uint64_t column, const string &content);
+
+    const string &m_input;
+    const uint8_t m_line_endings, m_tab_width;
+
+    AbstractTokenStreamPtr m_tokens;
+    size_t m_pos {0};
+    uint64_t m_row {1}, m_column {1};
+};
+
+inline const AbstractTokenStreamPtr &
+ByteWiseTokenizer::
+tokens() const
+{
+    return m_tokens;
+}
+
+} // namespace Verification
+} // namespace Abstract
+
+#endif // BYTEWISETOKENIZER_H
@@ -0,0 +1,178 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "DifferentialCheck.h"
+#include "ByteWiseTokenizer.h"
+#include "../tokenizer/LineIndex.h"
+using namespace Abstract::Verification;
+
+namespace {
+
+const size_t CHUNK_SIZES[] {1, 2, 3, 5, 8, 64};
+
+const uint8_t LINE_ENDING_POLICIES[] {
+    AbstractTokenizer::LF | AbstractTokenizer::CRLF,
+    AbstractTokenizer::LF,
+    AbstractTokenizer::CR,
+    AbstractTokenizer::CRLF,
+    AbstractTokenizer::LF | AbstractTokenizer::CR | AbstractTokenizer::CRLF | AbstractTokenizer::UNICODE_LS_PS
+};
+
+string
+describe(const AbstractToken &token)
+{
+    stringstream description;
+
+    description
+        << "kind "     << token.kind()
+        << " row "     << token.row()
+        << " column "  << token.column()
+        << " offset "  << token.offset()
+        << " length "  << token.sourceLength()
+        << " content '" << (token.contentPtr() ? token.content() : string()) << "'";
+
+    return description.str();
+}
+
+bool
+isAscii(const string &input)
+{
+    for (const auto ch : input)
+        if (uint8_t(ch) >= 0x80) return false;
+
+    return true;
+}
+
+} // namespace
+
+bool
+DifferentialCheck::
+run(const string &input, string &report)
+{
+    for (const auto line_endings : LINE_ENDING_POLICIES) {
+        if (!run(input, line_endings, report)) {
+            report = "Line endings " + to_string(line_endings) + ": " + report;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+DifferentialCheck::
+run(const string &input, const uint8_t line_endings, string &report)
+{
+    ReferenceTokenizer reference(input, nullptr, line_endings);
+    const auto reference_result = reference.run();
+
+    // The scalar scan itself is checked against the byte-wise oracle
+    ByteWiseTokenizer byte_wise(input, line_endings);
+
+    if (byte_wise.run() != reference_result) {
+        report = "Byte-wise reference: result differs from scalar scan";
+        return false;
+    }
+
+    if (reference_result && !compareTokenStreams(*byte_wise.tokens(), *reference.tokens(), report)) {
+        report = "Byte-wise reference: " + report;
+        return false;
+    }
+
+    if (reference_result) {
+        string content = input;
+        const LineIndex lines(content.begin(), content.end(), line_endings);
+
+        for (const auto &token : *reference.tokens()) {
+            if (lines.lineOf(token->offset()) + 1 != token->row()) {
+                report = "Line index: line " + to_string(lines.lineOf(token->offset()) + 1) +
+                         " for token " + describe(*token);
+                return false;
+            }
+        }
+    }
+
+    // Resumable mode has to reach the same result for every chunking
+    for (const auto chunk_size : CHUNK_SIZES) {
+        ReferenceTokenizer chunked("", nullptr, line_endings);
+        auto result = AbstractTokenizer::NEED_MORE_INPUT;
+
+        for (size_t pos = 0; pos < input.length() && result == AbstractTokenizer::NEED_MORE_INPUT; pos += chunk_size)
+            result = chunked.feed(input.substr(pos, chunk_size));
+
+        if (result == AbstractTokenizer::NEED_MORE_INPUT)
+            result = chunked.feed("", true);
+
+        if ((result == AbstractTokenizer::FINISHED) != reference_result) {
+            report = "Chunk size " + to_string(chunk_size) + ": result differs from scalar scan";
+            return false;
+        }
+
+        if (reference_result && !compareTokenStreams(*reference.tokens(), *chunked.tokens(), report)) {
+            report = "Chunk size " + to_string(chunk_size) + ": " + report;
+            return false;
+        }
+    }
+
+    // The DFA rules only mirror the scalar scanner for ASCII input
+    if (reference_result && isAscii(input)) {
+        static const Lexer lexer(ReferenceTokenizer::lexerSpecification());
+        ReferenceTokenizer lexed(input, &lexer, line_endings);
+
+        if (!lexed.run()) {
+            report = "Lexer: " + lexed.errorMessage();
+            return false;
+        }
+
+        if (!compareTokenStreams(*reference.tokens(), *lexed.tokens(), report)) {
+            report = "Lexer: " + report;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+DifferentialCheck::
+compareTokenStreams(const AbstractTokenStream &expected, const AbstractTokenStream &actual, string &report)
+{
+    const auto count = min(expected.size(), actual.size());
+
+    for (size_t i = 0; i < count; ++i) {
+        const auto &a = *expected[i], &b = *actual[i];
+
+        if (a.kind() != b.kind() || a.row() != b.row() || a.column() != b.column() ||
+            a.offset() != b.offset() || a.sourceLength() != b.sourceLength() ||
+            bool(a.contentPtr()) != bool(b.contentPtr()) ||
+            (a.contentPtr() && a.content() != b.content())) {
+            report = "Token " + to_string(i) + ": expected " + describe(a) + ", got " + describe(b);
+            return false;
+        }
+    }
+
+    if (expected.size() != actual.size()) {
+        report = "Expected " + to_string(expected.size()) + " tokens, got " + to_string(actual.size());
+        return false;
+    }
+
+    return true;
+}
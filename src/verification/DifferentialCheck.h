@@ -0,0 +1,56 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef DIFFERENTIALCHECK_H
+#define DIFFERENTIALCHECK_H
+#include "ReferenceTokenizer.h"
+
+namespace Abstract {
+namespace Verification {
+
+// Runs ReferenceTokenizer over an input in every available mode (scalar,
+// lexer DFA, resumable feeding in chunks of various sizes) and compares the
+// resulting token streams byte for byte, including kinds and positions.
+// The scalar scan is compared against ByteWiseTokenizer, which shares no
+// scanning code with it, and the rows of its tokens against LineIndex.
+// fuzz/DifferentialFuzzer.cpp runs this as a libFuzzer target
+// (ABSTRACTPARSER_FUZZ).
+class DifferentialCheck
+{
+public:
+    DifferentialCheck() = delete;
+
+    // Checks the input under every line ending policy
+    static bool
+    run                     (const string &input, string &report),
+    run                     (const string &input, const uint8_t line_endings, string &report);
+
+    // Describes the first difference in report
+    static bool
+    compareTokenStreams     (const AbstractTokenStream &expected,
+                             const AbstractTokenStream &actual,
+                             string &report);
+};
+
+} // namespace Verification
+} // namespace Abstract
+
+#endif // DIFFERENTIALCHECK_H
@@ -0,0 +1,107 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#include "ReferenceTokenizer.h"
+using namespace Abstract::Verification;
+
+ReferenceTokenizer::ReferenceTokenizer(const string &content, const Lexer *lexer, const uint8_t line_endings) :
+    AbstractTokenizer(content), m_lexer(lexer)
+{
+    setLineEndings(line_endings);
+}
+
+bool
+ReferenceTokenizer::
+run()
+{
+    while (!isEof())
+        if (!tokenizeNext())
+            return false;
+
+    return true;
+}
+
+bool
+ReferenceTokenizer::
+tokenizeNext()
+{
+    if (m_lexer)
+        return scanToken(*m_lexer);
+
+    skipSpace();
+
+    if (isEof())
+        return true;
+
+    const auto row = currentRow(), column = currentColumn();
+    const auto offset = inputOffset();
+    const auto begin = getIterator();
+    CharSpan span;
+    uint16_t kind;
+
+    if (posStartsWith("/*")) {
+        if (!isComment("/*", "*/", span)) {
+            throwSyntaxError("Unterminated comment");
+            return false;
+        }
+
+        kind = COMMENT;
+    }
+    else if (currentChar({'"', '\''})) {
+        if (!isString(span)) {
+            throwSyntaxError("Unterminated string");
+            return false;
+        }
+
+        kind = STRING;
+    }
+    else if (isTerm(span))
+        kind = TERM;
+    else {
+        advance();
+        span = CharSpan(begin, getIterator());
+        kind = CHARACTER;
+    }
+
+    const auto token = make_shared<AbstractToken>(span.toString());
+    token->setKind(kind);
+    appendToken(token, row, column, offset);
+
+    return true;
+}
+
+LexerSpecification
+ReferenceTokenizer::
+lexerSpecification()
+{
+    LexerSpecification specification;
+
+    specification
+        .addSkipRule("[ \t\n\v\f\r]+")
+        .addRule("/\\*([^*]|\\*+[^*/])*\\*+/", COMMENT, 1, [](const CharSpan &match) {
+            return make_shared<AbstractToken>(string(match.begin() + 2, match.end() - 2));
+        })
+        .addRule("\"[^\"]*\"|'[^']*'", STRING, 1)
+        .addRule("[A-Za-z][A-Za-z0-9_\\-]*", TERM, 1)
+        .addRule(".|\n", CHARACTER);
+
+    return specification;
+}
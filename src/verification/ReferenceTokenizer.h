@@ -0,0 +1,75 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+#ifndef REFERENCETOKENIZER_H
+#define REFERENCETOKENIZER_H
+#include "../tokenizer/AbstractTokenizer.h"
+#include "../tokenizer/Lexer.h"
+
+namespace Abstract {
+namespace Verification {
+using namespace Abstract::Tokenization;
+
+// Concrete tokenizer built only on the scalar scanning helpers of
+// AbstractTokenizer (skipSpace, isComment, isString, isTerm, advance). It
+// serves as oracle for optimized scanning modes: whitespace is skipped,
+// "/* */" comments, quoted strings and terms become tokens, any other
+// character becomes a single character token.
+class ReferenceTokenizer : public AbstractTokenizer
+{
+public:
+    enum Kind : uint16_t { TERM = 1, STRING, COMMENT, CHARACTER };
+
+    // Without a lexer the scalar helpers are used, with a lexer (compiled
+    // from lexerSpecification()) the DFA path is used
+    explicit
+    ReferenceTokenizer(const string &content = "", const Lexer *lexer = nullptr,
+                       const uint8_t line_endings = LF | CRLF);
+
+    bool
+    run                     ();
+
+    inline const AbstractTokenStreamPtr
+    tokens                  () const;
+
+    // DFA rules which are equivalent to the scalar scanner for ASCII input
+    static LexerSpecification
+    lexerSpecification      ();
+
+protected:
+    bool
+    tokenizeNext            () override;
+
+private:
+    const Lexer *m_lexer;
+};
+
+inline const AbstractTokenStreamPtr
+ReferenceTokenizer::
+tokens() const
+{
+    return tokenStream();
+}
+
+} // namespace Verification
+} // namespace Abstract
+
+#endif // REFERENCETOKENIZER_H
@@ -0,0 +1,84 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+// Encoding detection and transcoding through AbstractTokenizer, in
+// particular short input for which the padding of the byte stream must not
+// take part in the detection.
+
+#include "../src/tokenizer/AbstractTokenizer.h"
+#include <iostream>
+
+using namespace Abstract::Tokenization;
+
+namespace {
+
+class EncodingTokenizer : public AbstractTokenizer
+{
+public:
+    explicit
+    EncodingTokenizer(const string &content);
+
+    // Detects the encoding and returns the transcoded input behind a BOM
+    string
+    normalized              ();
+};
+
+EncodingTokenizer::EncodingTokenizer(const string &content) :
+    AbstractTokenizer(content) {}
+
+string
+EncodingTokenizer::
+normalized()
+{
+    if (!normalizeEncoding())
+        return "<failed>";
+
+    return string(getIterator(), inputEnd());
+}
+
+bool
+check(const string &name, const string &input, const string &expected)
+{
+    EncodingTokenizer tokenizer(input);
+    const auto result = tokenizer.normalized();
+
+    if (result == expected)
+        return true;
+
+    cerr << name << ": expected '" << expected << "', got '" << result << "'" << endl;
+    return false;
+}
+
+} // namespace
+
+int
+main()
+{
+    bool ok = true;
+
+    ok &= check("UTF-16LE without BOM", string("h\0e\0l\0l\0o\0", 10), "hello");
+    ok &= check("UTF-16BE without BOM", string("\0h\0i", 4), "hi");
+    ok &= check("UTF-16LE with BOM", string("\xff\xfeh\0i\0", 6), "hi");
+    ok &= check("UTF-8 with BOM", "\xef\xbb\xbfhi", "hi");
+    ok &= check("ASCII", "hello", "hello");
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+// Scanning with the CharSpan overloads of the helpers must not allocate:
+// a document is scanned once to warm up, then scanned again while counting
+// every global operator new.
+
+#include "../src/profiling/ScalingReport.h"
+#include "../src/tokenizer/KeywordSet.h"
+#include <iostream>
+
+ABSTRACTPARSER_COUNT_ALLOCATIONS
+
+using namespace Abstract::Profiling;
+using namespace Abstract::Tokenization;
+
+namespace {
+
+const char SNIPPET[] =
+    "while (x_1 <= y) {\r\n"
+    "\tname = \"str ing\"; /* comment\n spanning lines */ caf\xc3\xa9 += 'c';\n"
+    "\t\xce\xbbx -> IF_not_keyword; if (a) b-c;\n"
+    "}\n";
+
+class SpanScanner : public AbstractTokenizer
+{
+public:
+    explicit
+    SpanScanner(const string &content);
+
+    // Number of spans scanned from the beginning of the input
+    uint64_t
+    scan                    ();
+
+private:
+    const string m_comment_begin, m_comment_end, m_delimiters;
+    KeywordSet m_keywords;
+};
+
+SpanScanner::SpanScanner(const string &content) :
+    AbstractTokenizer(content),
+    m_comment_begin("/*"), m_comment_end("*/"), m_delimiters(" \t\r\n\"'/;(){}")
+{
+    m_keywords.add("while");
+    m_keywords.add("if");
+}
+
+uint64_t
+SpanScanner::
+scan()
+{
+    setIterator(byteStream()->begin());
+    uint64_t spans = 0;
+
+    while (!isEof()) {
+        skipSpace();
+
+        if (isEof())
+            break;
+
+        CharSpan span;
+
+        if (isComment(m_comment_begin, m_comment_end, span) ||
+            isString(span) ||
+            isKeyword(m_keywords, span) ||
+            isTerm(span) ||
+            readCharSequence(m_delimiters, span))
+            ++spans;
+        else
+            advance();
+    }
+
+    return spans;
+}
+
+} // namespace
+
+int
+main()
+{
+    string content;
+
+    for (int i = 0; i < 1000; ++i)
+        content += SNIPPET;
+
+    SpanScanner scanner(content);
+    const auto expected = scanner.scan();
+
+    const auto allocations = AllocationCounter::allocations();
+    const auto spans = scanner.scan();
+    const auto allocated = AllocationCounter::allocations() - allocations;
+
+    if (!spans || spans != expected) {
+        cerr << "Scanned " << spans << " spans, expected " << expected << endl;
+        return 1;
+    }
+
+    if (allocated) {
+        cerr << allocated << " heap allocations while scanning " << spans << " spans" << endl;
+        return 1;
+    }
+
+    cout << "Scanned " << spans << " spans without heap allocations" << endl;
+    return 0;
+}
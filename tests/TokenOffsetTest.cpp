@@ -0,0 +1,153 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+// Source ranges of tokens appended without an explicit offset, whose
+// content leaves out delimiters of the source text, also when the input is
+// fed in chunks and consumed input gets dropped.
+
+#include "../src/tokenizer/AbstractTokenizer.h"
+#include <iostream>
+
+using namespace Abstract::Tokenization;
+
+namespace {
+
+const string INPUT = "  /* ab */ \"xy\"\n  foo /**/ bar";
+
+struct Range
+{
+    uint64_t offset, source_length;
+};
+
+const Range EXPECTED[] {{2, 8}, {11, 4}, {18, 3}, {22, 4}, {27, 3}};
+
+class OffsetTokenizer : public AbstractTokenizer
+{
+public:
+    explicit
+    OffsetTokenizer(const string &content = "");
+
+    bool
+    tokenizeAll             ();
+
+    const AbstractTokenStream &
+    tokens                  () const;
+
+protected:
+    bool
+    tokenizeNext            () override;
+};
+
+OffsetTokenizer::OffsetTokenizer(const string &content) :
+    AbstractTokenizer(content) {}
+
+bool
+OffsetTokenizer::
+tokenizeAll()
+{
+    while (!isEof())
+        if (!tokenizeNext())
+            return false;
+
+    return true;
+}
+
+const AbstractTokenStream &
+OffsetTokenizer::
+tokens() const
+{
+    return *tokenStream();
+}
+
+bool
+OffsetTokenizer::
+tokenizeNext()
+{
+    string content;
+
+    skipSpace();
+
+    if (isEof())
+        return true;
+
+    if (isComment("/*", "*/", content) || isString(content) || isTerm(&content)) {
+        appendToken(make_shared<AbstractToken>(content));
+        return true;
+    }
+
+    // The token may be completed by the next chunk
+    if (!inputComplete()) {
+        setIterator(inputEnd());
+        return true;
+    }
+
+    throwSyntaxError();
+    return false;
+}
+
+bool
+check(const string &name, const AbstractTokenStream &tokens)
+{
+    const auto count = sizeof(EXPECTED) / sizeof(EXPECTED[0]);
+
+    if (tokens.size() != count) {
+        cerr << name << ": expected " << count << " tokens, got " << tokens.size() << endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (tokens[i]->offset() != EXPECTED[i].offset ||
+            tokens[i]->sourceLength() != EXPECTED[i].source_length) {
+            cerr << name << ": token " << i << " covers " << tokens[i]->offset() << "+"
+                 << tokens[i]->sourceLength() << ", expected " << EXPECTED[i].offset << "+"
+                 << EXPECTED[i].source_length << endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+int
+main()
+{
+    bool ok = true;
+
+    {
+        OffsetTokenizer tokenizer(INPUT);
+        ok &= tokenizer.tokenizeAll() && check("whole input", tokenizer.tokens());
+    }
+
+    for (const size_t chunk_size : {1, 2, 3, 5}) {
+        OffsetTokenizer tokenizer;
+        auto result = AbstractTokenizer::NEED_MORE_INPUT;
+
+        for (size_t pos = 0; pos < INPUT.length() && result == AbstractTokenizer::NEED_MORE_INPUT; pos += chunk_size)
+            result = tokenizer.feed(INPUT.substr(pos, chunk_size), pos + chunk_size >= INPUT.length());
+
+        ok &= result == AbstractTokenizer::FINISHED &&
+              check("chunks of " + to_string(chunk_size), tokenizer.tokens());
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+/******************************************************************************
+AbstractParserLibrary - A C++ parser library which can be used as base
+                        for specific parsers
+
+Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU Lesser General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program. If not, see <https://www.gnu.org/licenses/>.
+*******************************************************************************/
+
+
+// UTF-8 decoding used for identifier classification: valid sequences of
+// every length decode to their code point, overlong encodings, surrogates
+// and truncated sequences are rejected.
+
+#include "../src/tokenizer/UnicodeIdentifier.h"
+#include <iostream>
+#include <string>
+
+using namespace std;
+using namespace Abstract::Tokenization;
+
+namespace {
+
+bool
+check(const string &name, const string &input, const uint8_t expected_length,
+      const uint32_t expected_code_point = 0)
+{
+    uint32_t code_point = 0;
+    const auto length = UnicodeIdentifier::decodeUtf8(input.data(), input.data() + input.length(), code_point);
+
+    if (length == expected_length && (!length || code_point == expected_code_point))
+        return true;
+
+    cerr << name << ": expected length " << int(expected_length) << " and U+" << hex << expected_code_point
+         << ", got length " << dec << int(length) << " and U+" << hex << code_point << dec << endl;
+    return false;
+}
+
+} // namespace
+
+int
+main()
+{
+    bool ok = true;
+
+    ok &= check("ASCII", "A", 1, 'A');
+    ok &= check("2 bytes", "\xc3\xa9", 2, 0xe9);
+    ok &= check("3 bytes", "\xe2\x82\xac", 3, 0x20ac);
+    ok &= check("4 bytes", "\xf0\x9f\x98\x80", 4, 0x1f600);
+    ok &= check("Last code point", "\xf4\x8f\xbf\xbf", 4, 0x10ffff);
+    ok &= check("Below the surrogates", "\xed\x9f\xbf", 3, 0xd7ff);
+    ok &= check("Above the surrogates", "\xee\x80\x80", 3, 0xe000);
+
+    ok &= check("Overlong 'A' in 2 bytes", "\xc1\x81", 0);
+    ok &= check("Overlong NUL in 2 bytes", "\xc0\x80", 0);
+    ok &= check("Overlong in 3 bytes", "\xe0\x9f\xbf", 0);
+    ok &= check("Overlong in 4 bytes", "\xf0\x8f\xbf\xbf", 0);
+    ok &= check("High surrogate", "\xed\xa0\x80", 0);
+    ok &= check("Low surrogate", "\xed\xbf\xbf", 0);
+    ok &= check("Above U+10FFFF", "\xf4\x90\x80\x80", 0);
+    ok &= check("Truncated", "\xe2\x82", 0);
+    ok &= check("Missing continuation byte", "\xe2\x41\xac", 0);
+
+    // 'A' must not start an identifier through an overlong encoding
+    uint32_t code_point = 0;
+    const string overlong = "\xc1\x81";
+
+    if (UnicodeIdentifier::decodeUtf8(overlong.data(), overlong.data() + 2, code_point) &&
+        UnicodeIdentifier::isStart(code_point)) {
+        cerr << "Overlong 'A' starts an identifier" << endl;
+        ok = false;
+    }
+
+    return ok ? 0 : 1;
+}
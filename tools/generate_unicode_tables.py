@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+###############################################################################
+# AbstractParserLibrary - A C++ parser library which can be used as base
+#                         for specific parsers
+#
+# Copyright (C) 2019-2020 Waldemar Zimpel <hspp@utilizer.de>
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program. If not, see <https://www.gnu.org/licenses/>.
+###############################################################################
+
+# Generates the two-stage XID_Start/XID_Continue lookup tables used by
+# UnicodeIdentifier.h from the Unicode database shipped with Python.
+#
+# Usage: generate_unicode_tables.py <output.cpp>
+
+import sys
+import unicodedata
+
+BLOCK_SIZE = 256
+CODE_POINTS = 0x110000
+
+
+def classify():
+    start = bytearray(CODE_POINTS)
+    cont = bytearray(CODE_POINTS)
+
+    for cp in range(CODE_POINTS):
+        if 0xd800 <= cp < 0xe000:
+            continue
+
+        ch = chr(cp)
+
+        # Python identifiers are XID_Start/XID_Continue plus '_' as start
+        if ch != '_' and ch.isidentifier():
+            start[cp] = 1
+
+        if ('a' + ch).isidentifier():
+            cont[cp] = 1
+
+    return start, cont
+
+
+def words(bits):
+    return [sum(bits[w * 64 + i] << i for i in range(64)) for w in range(BLOCK_SIZE // 64)]
+
+
+def main():
+    start, cont = classify()
+    blocks, stage1 = {}, []
+
+    for b in range(CODE_POINTS // BLOCK_SIZE):
+        key = tuple(words(start[b * BLOCK_SIZE:(b + 1) * BLOCK_SIZE]) +
+                    words(cont[b * BLOCK_SIZE:(b + 1) * BLOCK_SIZE]))
+        stage1.append(blocks.setdefault(key, len(blocks)))
+
+    assert len(blocks) <= 256
+
+    with open(__file__) as script:
+        license_lines = [line[2:].rstrip() if len(line) > 2 else ''
+                         for line in script.read().split("\n")[2:19]]
+
+    out = ['/' + '*' * 78]
+    out += license_lines
+    out += ['*' * 79 + '/', '', '',
+            '// Generated by tools/generate_unicode_tables.py from Unicode %s. Do not edit.'
+            % unicodedata.unidata_version, '',
+            '#include "UnicodeIdentifier.h"',
+            'using namespace Abstract::Tokenization;', '',
+            'const uint8_t UnicodeIdentifier::ASCII_CLASSES[128] {']
+
+    ascii = [(1 if chr(c).isalpha() else 0) |
+             (2 if chr(c).isalnum() or chr(c) in '-_' else 0) for c in range(128)]
+
+    for i in range(0, 128, 16):
+        out.append('    ' + ', '.join('%d' % v for v in ascii[i:i + 16]) + ',')
+
+    out += ['};', '', 'const uint8_t UnicodeIdentifier::STAGE1[%d] {' % len(stage1)]
+
+    for i in range(0, len(stage1), 16):
+        out.append('    ' + ', '.join('%3d' % v for v in stage1[i:i + 16]) + ',')
+
+    out += ['};', '', 'const uint64_t UnicodeIdentifier::STAGE2[%d][8] {' % len(blocks)]
+
+    for key in sorted(blocks, key=blocks.get):
+        out.append('    {' + ', '.join('0x%016xULL' % w for w in key) + '},')
+
+    out += ['};', '']
+
+    with open(sys.argv[1], 'w') as output:
+        output.write('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()